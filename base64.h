@@ -1,7 +1,15 @@
 #pragma once
 
-#include "impl/encode.h"
-#include "impl/decode.h"
+#include "base64_raw.h"
+#include "impl/codec.h"
+#include "impl/sink.h"
+
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 
 namespace base64
@@ -11,8 +19,7 @@ namespace base64
     // encode functions declaration
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
-    size_t calc_encoded_size(size_t raw_size) noexcept;
-    size_t calc_encoded_size_url(size_t raw_size) noexcept;
+    // calc_encoded_size() and calc_encoded_size_url() are declared in base64_raw.h
 
     template <typename raw_array, typename base64_array>
     error_code_t encode(
@@ -24,6 +31,56 @@ namespace base64
         const raw_array     & raw_data,
         base64_array        & base64_data);
 
+    // Allocating encoding: the string is allocated once at the exact size (without zero-filling
+    // when std::string::resize_and_overwrite is available) by the allocator or the memory resource.
+    template <typename raw_array, typename allocator_type = std::allocator<char>>
+        requires (!std::is_convertible_v<allocator_type, std::pmr::memory_resource *>)
+    basic_string_t<allocator_type> encode_to_string(
+        const raw_array         & raw_data,
+        const allocator_type    & allocator = allocator_type());
+
+    template <typename raw_array, typename allocator_type = std::allocator<char>>
+        requires (!std::is_convertible_v<allocator_type, std::pmr::memory_resource *>)
+    basic_string_t<allocator_type> encode_url_to_string(
+        const raw_array         & raw_data,
+        const allocator_type    & allocator = allocator_type());
+
+    template <typename raw_array>
+    std::pmr::string encode_to_string(
+        const raw_array             & raw_data,
+        std::pmr::memory_resource   * resource);
+
+    template <typename raw_array>
+    std::pmr::string encode_url_to_string(
+        const raw_array             & raw_data,
+        std::pmr::memory_resource   * resource);
+
+    // In-place encoding: the buffer of calc_encoded_size(raw_size) bytes contains the raw data at
+    // its beginning, the data is replaced by its encoding.
+    template <typename base64_array>
+    error_code_t encode_inplace(base64_array & buffer, size_t raw_size);
+
+    template <typename base64_array>
+    error_code_t encode_url_inplace(base64_array & buffer, size_t raw_size);
+
+    // Encoding to a sink: a callable void(const char * data, size_t size) or an output iterator
+    // of char. The output is passed in blocks staged on the stack (see impl/sink.h). The sink is
+    // used in place: an output iterator passed as an lvalue is advanced past the output, while
+    // a temporary one (e.g. std::back_inserter(str)) is advanced only internally.
+    template <typename raw_array, sink_of<char> sink_type>
+    void encode_to_sink(const raw_array & raw_data, sink_type && sink);
+
+    template <typename raw_array, sink_of<char> sink_type>
+    void encode_url_to_sink(const raw_array & raw_data, sink_type && sink);
+
+    // Appending encoding: the string or the vector of bytes is grown once by calc_encoded_size()
+    // and the data is encoded straight into the new tail.
+    template <typename raw_array, typename base64_container>
+    void encode_append(const raw_array & raw_data, base64_container & base64_data);
+
+    template <typename raw_array, typename base64_container>
+    void encode_url_append(const raw_array & raw_data, base64_container & base64_data);
+
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,23 +103,70 @@ namespace base64
         const base64_array      & base64_data,
         raw_array               & raw_data);
 
+    // Strict decoding: only the canonical encoding is accepted, the misplaced_pad and
+    // non_canonical_trailing_bits errors are reported additionally.
+    template <typename base64_array, typename raw_array>
+    error_code_t decode_strict(
+        const base64_array      & base64_data,
+        raw_array               & raw_data);
 
+    template <typename base64_array, typename raw_array>
+    error_code_t decode_url_strict(
+        const base64_array      & base64_data,
+        raw_array               & raw_data);
+
+    // In-place decoding: the decoded data is written over the beginning of the base64 data.
+    // raw_size receives the decoded size (on error, the size of the data decoded before the error).
+    template <typename base64_array>
+    error_code_t decode_inplace(base64_array & base64_data, size_t & raw_size);
+
+    template <typename base64_array>
+    error_code_t decode_url_inplace(base64_array & base64_data, size_t & raw_size);
+
+    // Decoding to a sink: a callable void(const uint8_t * data, size_t size) or an output iterator
+    // of uint8_t. On error the sink has received the data decoded before the invalid symbol.
+    // An output iterator passed as an lvalue is advanced past the decoded data (as in
+    // encode_to_sink()), so it marks the end of the output even on error.
+    template <typename base64_array, sink_of<uint8_t> sink_type>
+    error_code_t decode_to_sink(const base64_array & base64_data, sink_type && sink);
+
+    template <typename base64_array, sink_of<uint8_t> sink_type>
+    error_code_t decode_url_to_sink(const base64_array & base64_data, sink_type && sink);
+
+    // Allocating decoding: the vector is resized once to the exact size by its allocator,
+    // byte_vector_t and pmr::byte_vector_t avoid zero-filling. On error the vector contains
+    // the data decoded before the invalid symbol.
+    template <typename base64_array, typename allocator_type>
+    error_code_t decode_to_vector(
+        const base64_array                      & base64_data,
+        std::vector<uint8_t, allocator_type>    & raw_data);
+
+    template <typename base64_array, typename allocator_type>
+    error_code_t decode_url_to_vector(
+        const base64_array                      & base64_data,
+        std::vector<uint8_t, allocator_type>    & raw_data);
+
+    // Checks the data without decoding: returns the same errors as the decoding functions
+    // except insufficient_buffer_size.
+    template <typename base64_array>
+    error_code_t validate(const base64_array & base64_data);
+
+    template <typename base64_array>
+    error_code_t validate_url(const base64_array & base64_data);
+
+    // Stores the indexes of all non-alphabetic symbols (up to positions.size() of them) in one
+    // pass. Returns the number of stored indexes.
+    template <typename base64_array>
+    size_t find_invalid_symbols(const base64_array & base64_data, std::span<size_t> positions);
+
+    template <typename base64_array>
+    size_t find_invalid_symbols_url(const base64_array & base64_data, std::span<size_t> positions);
 
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    // encode functions (definition)
-    ////////////////////////////////////////////////////////////////////////////////////////////////
 
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    inline size_t calc_encoded_size(size_t raw_size) noexcept
-    {
-        return calc_encoded_size_impl<def_encoding_t>(raw_size);
-    }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
-    inline size_t calc_encoded_size_url(size_t raw_size) noexcept
-    {
-        return calc_encoded_size_impl<url_encoding_t>(raw_size);
-    }
+    // encode functions (definition)
+    ////////////////////////////////////////////////////////////////////////////////////////////////
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     template <typename raw_array, typename base64_array>
@@ -86,6 +190,90 @@ namespace base64
             make_mutable_adapter(base64_data));
     }
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename raw_array, typename allocator_type>
+        requires (!std::is_convertible_v<allocator_type, std::pmr::memory_resource *>)
+    inline basic_string_t<allocator_type> encode_to_string(
+        const raw_array         & raw_data,
+        const allocator_type    & allocator)
+    {
+        basic_string_t<allocator_type> base64_data(allocator);
+        encode_append_impl<def_encoding_t>(make_const_adapter(raw_data), base64_data);
+        return base64_data;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename raw_array, typename allocator_type>
+        requires (!std::is_convertible_v<allocator_type, std::pmr::memory_resource *>)
+    inline basic_string_t<allocator_type> encode_url_to_string(
+        const raw_array         & raw_data,
+        const allocator_type    & allocator)
+    {
+        basic_string_t<allocator_type> base64_data(allocator);
+        encode_append_impl<url_encoding_t>(make_const_adapter(raw_data), base64_data);
+        return base64_data;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename raw_array>
+    inline std::pmr::string encode_to_string(
+        const raw_array             & raw_data,
+        std::pmr::memory_resource   * resource)
+    {
+        return encode_to_string(raw_data, std::pmr::polymorphic_allocator<char>(resource));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename raw_array>
+    inline std::pmr::string encode_url_to_string(
+        const raw_array             & raw_data,
+        std::pmr::memory_resource   * resource)
+    {
+        return encode_url_to_string(raw_data, std::pmr::polymorphic_allocator<char>(resource));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array>
+    inline error_code_t encode_inplace(base64_array & buffer, size_t raw_size)
+    {
+        return encode_inplace_impl<def_encoding_t>(make_mutable_adapter(buffer), raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array>
+    inline error_code_t encode_url_inplace(base64_array & buffer, size_t raw_size)
+    {
+        return encode_inplace_impl<url_encoding_t>(make_mutable_adapter(buffer), raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename raw_array, sink_of<char> sink_type>
+    inline void encode_to_sink(const raw_array & raw_data, sink_type && sink)
+    {
+        encode_to_sink_impl<def_encoding_t>(make_const_adapter(raw_data), sink);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename raw_array, sink_of<char> sink_type>
+    inline void encode_url_to_sink(const raw_array & raw_data, sink_type && sink)
+    {
+        encode_to_sink_impl<url_encoding_t>(make_const_adapter(raw_data), sink);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename raw_array, typename base64_container>
+    inline void encode_append(const raw_array & raw_data, base64_container & base64_data)
+    {
+        encode_append_impl<def_encoding_t>(make_const_adapter(raw_data), base64_data);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename raw_array, typename base64_container>
+    inline void encode_url_append(const raw_array & raw_data, base64_container & base64_data)
+    {
+        encode_append_impl<url_encoding_t>(make_const_adapter(raw_data), base64_data);
+    }
+
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -128,4 +316,108 @@ namespace base64
             make_mutable_adapter(raw_data));
     }
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array, typename raw_array>
+    inline error_code_t decode_strict(
+        const base64_array      & base64_data,
+        raw_array               & raw_data)
+    {
+        return decode_impl<def_encoding_t, decode_mode_t::strict>(
+            make_const_adapter(base64_data),
+            make_mutable_adapter(raw_data));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array, typename raw_array>
+    inline error_code_t decode_url_strict(
+        const base64_array      & base64_data,
+        raw_array               & raw_data)
+    {
+        return decode_impl<url_encoding_t, decode_mode_t::strict>(
+            make_const_adapter(base64_data),
+            make_mutable_adapter(raw_data));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array>
+    inline error_code_t decode_inplace(base64_array & base64_data, size_t & raw_size)
+    {
+        return decode_inplace_impl<def_encoding_t>(make_mutable_adapter(base64_data), raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array>
+    inline error_code_t decode_url_inplace(base64_array & base64_data, size_t & raw_size)
+    {
+        return decode_inplace_impl<url_encoding_t>(make_mutable_adapter(base64_data), raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array, sink_of<uint8_t> sink_type>
+    inline error_code_t decode_to_sink(const base64_array & base64_data, sink_type && sink)
+    {
+        return decode_to_sink_impl<def_encoding_t>(make_const_adapter(base64_data), sink);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array, sink_of<uint8_t> sink_type>
+    inline error_code_t decode_url_to_sink(const base64_array & base64_data, sink_type && sink)
+    {
+        return decode_to_sink_impl<url_encoding_t>(make_const_adapter(base64_data), sink);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array, typename allocator_type>
+    inline error_code_t decode_to_vector(
+        const base64_array                      & base64_data,
+        std::vector<uint8_t, allocator_type>    & raw_data)
+    {
+        return decode_to_vector_impl<def_encoding_t>(make_const_adapter(base64_data), raw_data);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array, typename allocator_type>
+    inline error_code_t decode_url_to_vector(
+        const base64_array                      & base64_data,
+        std::vector<uint8_t, allocator_type>    & raw_data)
+    {
+        return decode_to_vector_impl<url_encoding_t>(make_const_adapter(base64_data), raw_data);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array>
+    inline error_code_t validate(const base64_array & base64_data)
+    {
+        return validate_impl<def_encoding_t>(make_const_adapter(base64_data));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array>
+    inline error_code_t validate_url(const base64_array & base64_data)
+    {
+        return validate_impl<url_encoding_t>(make_const_adapter(base64_data));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array>
+    inline size_t find_invalid_symbols(
+        const base64_array  & base64_data,
+        std::span<size_t>   positions)
+    {
+        const const_adapter_t adapter = make_const_adapter(base64_data);
+        return find_invalid_symbols_impl<def_encoding_t>(
+            adapter.data(), adapter.size(), positions.data(), positions.size());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename base64_array>
+    inline size_t find_invalid_symbols_url(
+        const base64_array  & base64_data,
+        std::span<size_t>   positions)
+    {
+        const const_adapter_t adapter = make_const_adapter(base64_data);
+        return find_invalid_symbols_impl<url_encoding_t>(
+            adapter.data(), adapter.size(), positions.data(), positions.size());
+    }
+
 }   // namespace base64
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "impl/encode.h"
+#include "impl/decode.h"
+#include "impl/result.h"
+#include "impl/validate.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+// Low-level functions working with plain pointers. They don't allocate memory and depend
+// neither on error_code_t nor on <string>: the result is a raw_result_t (see impl/result.h).
+
+
+namespace base64
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // low-level functions declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    size_t calc_encoded_size(size_t raw_size) noexcept;
+    size_t calc_encoded_size_url(size_t raw_size) noexcept;
+
+    raw_result_t encode_raw(
+        const uint8_t   * raw_data,
+        size_t          raw_size,
+        char            * base64_data,
+        size_t          base64_size) noexcept;
+
+    raw_result_t encode_url_raw(
+        const uint8_t   * raw_data,
+        size_t          raw_size,
+        char            * base64_data,
+        size_t          base64_size) noexcept;
+
+    // see encode_inplace() and encode_url_inplace() in base64.h
+    raw_result_t encode_inplace_raw(char * buffer, size_t raw_size, size_t buffer_size) noexcept;
+    raw_result_t encode_url_inplace_raw(char * buffer, size_t raw_size, size_t buffer_size) noexcept;
+
+    // The buffer size of 3 * (base64_size / 4) (or calc_decoded_size_url() for url_encoding)
+    // is always sufficient; a smaller buffer is accepted if the padding makes the output fit.
+    raw_result_t decode_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        uint8_t         * raw_data,
+        size_t          raw_size) noexcept;
+
+    raw_result_t decode_url_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        uint8_t         * raw_data,
+        size_t          raw_size) noexcept;
+
+    // see decode_strict() and decode_url_strict() in base64.h
+    raw_result_t decode_strict_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        uint8_t         * raw_data,
+        size_t          raw_size) noexcept;
+
+    raw_result_t decode_url_strict_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        uint8_t         * raw_data,
+        size_t          raw_size) noexcept;
+
+    // see decode_inplace() and decode_url_inplace() in base64.h
+    raw_result_t decode_inplace_raw(char * base64_data, size_t base64_size) noexcept;
+    raw_result_t decode_url_inplace_raw(char * base64_data, size_t base64_size) noexcept;
+
+    raw_result_t validate_raw(const char * base64_data, size_t base64_size) noexcept;
+    raw_result_t validate_url_raw(const char * base64_data, size_t base64_size) noexcept;
+
+    // see find_invalid_symbols() and find_invalid_symbols_url() in base64.h
+    size_t find_invalid_symbols_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        size_t          * positions,
+        size_t          max_count) noexcept;
+
+    size_t find_invalid_symbols_url_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        size_t          * positions,
+        size_t          max_count) noexcept;
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // low-level functions definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline size_t calc_encoded_size(size_t raw_size) noexcept
+    {
+        return calc_encoded_size_impl<def_encoding_t>(raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline size_t calc_encoded_size_url(size_t raw_size) noexcept
+    {
+        return calc_encoded_size_impl<url_encoding_t>(raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t encode_raw(
+        const uint8_t   * raw_data,
+        size_t          raw_size,
+        char            * base64_data,
+        size_t          base64_size) noexcept
+    {
+        return encode_raw_impl<def_encoding_t>(
+            raw_data, raw_size, static_cast<uint8_t *>(static_cast<void *>(base64_data)), base64_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t encode_url_raw(
+        const uint8_t   * raw_data,
+        size_t          raw_size,
+        char            * base64_data,
+        size_t          base64_size) noexcept
+    {
+        return encode_raw_impl<url_encoding_t>(
+            raw_data, raw_size, static_cast<uint8_t *>(static_cast<void *>(base64_data)), base64_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t encode_inplace_raw(char * buffer, size_t raw_size, size_t buffer_size) noexcept
+    {
+        return encode_inplace_raw_impl<def_encoding_t>(
+            static_cast<uint8_t *>(static_cast<void *>(buffer)), raw_size, buffer_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t encode_url_inplace_raw(char * buffer, size_t raw_size, size_t buffer_size) noexcept
+    {
+        return encode_inplace_raw_impl<url_encoding_t>(
+            static_cast<uint8_t *>(static_cast<void *>(buffer)), raw_size, buffer_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t decode_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        uint8_t         * raw_data,
+        size_t          raw_size) noexcept
+    {
+        return decode_raw_impl<def_encoding_t>(
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data)), base64_size, raw_data, raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t decode_url_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        uint8_t         * raw_data,
+        size_t          raw_size) noexcept
+    {
+        return decode_raw_impl<url_encoding_t>(
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data)), base64_size, raw_data, raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t decode_strict_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        uint8_t         * raw_data,
+        size_t          raw_size) noexcept
+    {
+        return decode_raw_impl<def_encoding_t, decode_mode_t::strict>(
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data)), base64_size, raw_data, raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t decode_url_strict_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        uint8_t         * raw_data,
+        size_t          raw_size) noexcept
+    {
+        return decode_raw_impl<url_encoding_t, decode_mode_t::strict>(
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data)), base64_size, raw_data, raw_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t decode_inplace_raw(char * base64_data, size_t base64_size) noexcept
+    {
+        return decode_inplace_raw_impl<def_encoding_t>(
+            static_cast<uint8_t *>(static_cast<void *>(base64_data)), base64_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t decode_url_inplace_raw(char * base64_data, size_t base64_size) noexcept
+    {
+        return decode_inplace_raw_impl<url_encoding_t>(
+            static_cast<uint8_t *>(static_cast<void *>(base64_data)), base64_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t validate_raw(const char * base64_data, size_t base64_size) noexcept
+    {
+        return validate_raw_impl<def_encoding_t>(
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data)), base64_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline raw_result_t validate_url_raw(const char * base64_data, size_t base64_size) noexcept
+    {
+        return validate_raw_impl<url_encoding_t>(
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data)), base64_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline size_t find_invalid_symbols_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        size_t          * positions,
+        size_t          max_count) noexcept
+    {
+        return find_invalid_symbols_impl<def_encoding_t>(
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data)), base64_size, positions, max_count);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline size_t find_invalid_symbols_url_raw(
+        const char      * base64_data,
+        size_t          base64_size,
+        size_t          * positions,
+        size_t          max_count) noexcept
+    {
+        return find_invalid_symbols_impl<url_encoding_t>(
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data)), base64_size, positions, max_count);
+    }
+
+}   // namespace base64
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "base64.h"
+
+
+// Decode latency of small inputs with hot and cold caches.
+//
+// hot  - the same input is decoded repeatedly, the lookup tables stay in L1
+// cold - a buffer larger than L2 is walked before every call, so the lookup tables
+//        (and the input) have to be fetched from the outer cache levels, like when
+//        the codec runs interleaved with other work
+
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr size_t sample_count = 501;
+    constexpr size_t hot_batch = 1000;
+    constexpr size_t eviction_size = 8 * 1024 * 1024;
+
+    volatile uint8_t sink = 0;
+
+
+    std::string make_encoded(size_t raw_size)
+    {
+        std::vector<uint8_t> raw(raw_size);
+        for (size_t i = 0; i < raw_size; ++i)
+            raw[i] = static_cast<uint8_t>(i * 7919 + 13);
+
+        std::string encoded(base64::calc_encoded_size(raw_size), '\0');
+        base64::encode(raw, encoded);
+        return encoded;
+    }
+
+
+    double median(std::vector<double> & samples)
+    {
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }
+
+
+    double hot_latency_ns(const std::string & encoded, std::vector<uint8_t> & decoded)
+    {
+        std::vector<double> samples(sample_count / 10);
+
+        for (double & sample : samples)
+        {
+            const auto start = clock_type::now();
+
+            for (size_t i = 0; i < hot_batch; ++i)
+                base64::decode(encoded, decoded);
+
+            const auto stop = clock_type::now();
+            sample = std::chrono::duration<double, std::nano>(stop - start).count() / hot_batch;
+            sink = sink + decoded[0];
+        }
+
+        return median(samples);
+    }
+
+
+    double cold_latency_ns(
+        const std::string & encoded,
+        std::vector<uint8_t> & decoded,
+        std::vector<uint8_t> & eviction)
+    {
+        std::vector<double> samples(sample_count);
+
+        for (double & sample : samples)
+        {
+            // touch every cache line of the eviction buffer
+            for (size_t i = 0; i < eviction.size(); i += 64)
+                eviction[i] = static_cast<uint8_t>(eviction[i] + 1);
+
+            const auto start = clock_type::now();
+            base64::decode(encoded, decoded);
+            const auto stop = clock_type::now();
+
+            sample = std::chrono::duration<double, std::nano>(stop - start).count();
+            sink = sink + decoded[0];
+        }
+
+        return median(samples);
+    }
+
+}   // namespace
+
+
+int main()
+{
+    std::vector<uint8_t> eviction(eviction_size);
+
+    using base64::kernel_t;
+
+    for (const kernel_t kernel : { kernel_t::scalar, kernel_t::scalar_x4, kernel_t::ssse3, kernel_t::avx2 })
+    {
+        if (!base64::set_kernel(kernel))
+            continue;
+
+        constexpr const char * kernel_names[] = { "scalar", "ssse3", "avx2", "scalar_x4" };
+        std::printf("kernel: %s\n", kernel_names[static_cast<int>(kernel)]);
+        std::printf("%10s %16s %16s\n", "raw bytes", "hot, ns/call", "cold, ns/call");
+
+        for (const size_t raw_size : { 12, 48, 96, 192, 384, 768 })
+        {
+            const std::string encoded = make_encoded(raw_size);
+            std::vector<uint8_t> decoded(base64::calc_decoded_size(encoded));
+
+            const double hot = hot_latency_ns(encoded, decoded);
+            const double cold = cold_latency_ns(encoded, decoded, eviction);
+
+            std::printf("%10zu %16.1f %16.1f\n", raw_size, hot, cold);
+        }
+
+        std::printf("\n");
+    }
+
+    return 0;
+}
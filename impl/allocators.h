@@ -0,0 +1,175 @@
+#pragma once
+
+#include "make_adapter.h"
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace base64
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // default_init_allocator_t class declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // The allocator default-initializes elements constructed without arguments, so resize() of
+    // a vector of bytes doesn't fill the memory that is overwritten by the decoding anyway.
+
+    template <typename value_type, typename base_allocator = std::allocator<value_type>>
+    class default_init_allocator_t : public base_allocator
+    {
+        using base_traits = std::allocator_traits<base_allocator>;
+
+    public:
+        template <typename other_type>
+        struct rebind
+        {
+            using other = default_init_allocator_t<
+                other_type, typename base_traits::template rebind_alloc<other_type>>;
+        };
+
+        using base_allocator::base_allocator;
+
+        default_init_allocator_t() noexcept(noexcept(base_allocator())) = default;
+
+        template <typename other_type, typename other_base>
+        default_init_allocator_t(const default_init_allocator_t<other_type, other_base> & other) noexcept;
+
+        template <typename object_type>
+        void construct(object_type * ptr) noexcept(std::is_nothrow_default_constructible_v<object_type>);
+
+        template <typename object_type, typename... arg_types>
+        void construct(object_type * ptr, arg_types &&... args);
+    };
+
+    using byte_vector_t = std::vector<uint8_t, default_init_allocator_t<uint8_t>>;
+
+    template <typename allocator_type>
+    using basic_string_t = std::basic_string<char, std::char_traits<char>, allocator_type>;
+
+namespace pmr
+{
+    // allocates from a std::pmr::memory_resource (e.g. a per-request arena) without zero-filling
+    using byte_vector_t = std::vector<uint8_t,
+        default_init_allocator_t<uint8_t, std::pmr::polymorphic_allocator<uint8_t>>>;
+
+}   // namespace pmr
+
+
+
+namespace detail
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // output helpers declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Grows the container once by tail_size bytes and fills the new tail with
+    // writer(uint8_t * data, size_t tail_pos, size_t tail_size) returning the number of written
+    // bytes, the container is shrunk to them. data points to the grown storage (the old content
+    // is kept at its beginning), so the writer may read the container itself. A string isn't
+    // zero-filled when the standard library provides std::basic_string::resize_and_overwrite.
+    template <typename char_type, typename traits_type, typename allocator_type, typename writer_type>
+    void append_overwrite(
+        std::basic_string<char_type, traits_type, allocator_type>   & str,
+        size_t                                                      tail_size,
+        writer_type                                                 writer);
+
+    template <typename pod_type, typename allocator_type, typename writer_type>
+    void append_overwrite(
+        std::vector<pod_type, allocator_type>                       & vec,
+        size_t                                                      tail_size,
+        writer_type                                                 writer);
+
+}   // namespace detail
+
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // default_init_allocator_t class definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename value_type, typename base_allocator>
+    template <typename other_type, typename other_base>
+    inline default_init_allocator_t<value_type, base_allocator>::default_init_allocator_t(
+        const default_init_allocator_t<other_type, other_base> & other) noexcept
+        : base_allocator(static_cast<const other_base &>(other))
+    {
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename value_type, typename base_allocator>
+    template <typename object_type>
+    inline void default_init_allocator_t<value_type, base_allocator>::construct(object_type * ptr)
+        noexcept(std::is_nothrow_default_constructible_v<object_type>)
+    {
+        ::new (static_cast<void *>(ptr)) object_type;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename value_type, typename base_allocator>
+    template <typename object_type, typename... arg_types>
+    inline void default_init_allocator_t<value_type, base_allocator>::construct(
+        object_type * ptr, arg_types &&... args)
+    {
+        base_traits::construct(
+            static_cast<base_allocator &>(*this), ptr, std::forward<arg_types>(args)...);
+    }
+
+
+
+namespace detail
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // output helpers definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename char_type, typename traits_type, typename allocator_type, typename writer_type>
+    inline void append_overwrite(
+        std::basic_string<char_type, traits_type, allocator_type>   & str,
+        size_t                                                      tail_size,
+        writer_type                                                 writer)
+    {
+        static_assert(sizeof(char_type) == 1, "the output must be a string of bytes");
+
+        const size_t size = str.size();
+
+#if defined(__cpp_lib_string_resize_and_overwrite)
+        str.resize_and_overwrite(size + tail_size, [size, &writer](char_type * data, size_t count)
+        {
+            uint8_t * const bytes = static_cast<uint8_t *>(static_cast<void *>(data));
+            return size + writer(bytes, size, count - size);
+        });
+#else
+        str.resize(size + tail_size);
+        const mutable_adapter_t adapter = make_mutable_adapter(str);
+        str.resize(size + writer(adapter.data(), size, tail_size));
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename pod_type, typename allocator_type, typename writer_type>
+    inline void append_overwrite(
+        std::vector<pod_type, allocator_type>                       & vec,
+        size_t                                                      tail_size,
+        writer_type                                                 writer)
+    {
+        static_assert(sizeof(pod_type) == 1, "the output must be a vector of bytes");
+
+        const size_t size = vec.size();
+        vec.resize(size + tail_size);
+
+        const mutable_adapter_t adapter = make_mutable_adapter(vec);
+        vec.resize(size + writer(adapter.data(), size, tail_size));
+    }
+
+}   // namespace detail
+}   // namespace base64
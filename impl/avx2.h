@@ -0,0 +1,359 @@
+#pragma once
+
+#include "config.h"
+#include "simd_traits.h"
+
+#if BASE64_HAS_AVX2
+
+#include <immintrin.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace base64
+{
+namespace detail
+{
+namespace avx2
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // AVX2 kernels declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Encodes the longest prefix of complete 24-byte blocks which can be processed without reading
+    // beyond src_size. Returns the number of consumed bytes (always a multiple of 3).
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    size_t encode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    // Decodes the longest prefix of complete 32-symbol blocks that contain only alphabetic symbols.
+    // Returns the number of consumed symbols (always a multiple of 4); the block containing a bad
+    // symbol (or a pad) is left to the scalar code.
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    size_t decode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    // Checks the longest prefix of complete 32-symbol blocks that contain only alphabetic symbols.
+    // Returns its size; the block containing a bad symbol (or a pad) is left to the scalar code.
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    size_t validate(const uint8_t * src, size_t src_size) noexcept;
+
+    // Returns the index of the first symbol which is neither alphabetic nor a pad, or the size of
+    // the longest prefix of complete 32-symbol blocks if there is no such symbol in the prefix.
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    size_t locate_invalid(const uint8_t * src, size_t src_size) noexcept;
+
+    // Stores the indexes of the symbols which are neither alphabetic nor a pad in the complete
+    // 32-symbol blocks of [pos, src_size) to positions[count, max_count) and advances count.
+    // Returns the end of the scanned blocks; the scan stops at the block that fills positions.
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    size_t collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          pos,
+        size_t          * positions,
+        size_t          max_count,
+        size_t          & count) noexcept;
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // AVX2 kernels definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    BASE64_TARGET_AVX2
+    inline __m128i load_128(const uint8_t * src) noexcept
+    {
+        return _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(src)));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    BASE64_TARGET_AVX2
+    inline __m256i load_256(const uint8_t * src) noexcept
+    {
+        return _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(src)));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    BASE64_TARGET_AVX2
+    inline void store_128(uint8_t * dst, __m128i value) noexcept
+    {
+        _mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(dst)), value);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    BASE64_TARGET_AVX2
+    inline void store_64(uint8_t * dst, __m128i value) noexcept
+    {
+        _mm_storel_epi64(static_cast<__m128i *>(static_cast<void *>(dst)), value);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    BASE64_TARGET_AVX2
+    inline void store_256(uint8_t * dst, __m256i value) noexcept
+    {
+        _mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(dst)), value);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // converts 32 sextets (one per byte) to symbols
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline __m256i sextets_to_symbols(__m256i sextets) noexcept
+    {
+        using simd_traits = simd_traits_t<encoding_traits>;
+
+        constexpr char shift_upper = 'A';
+        constexpr char shift_lower = 'a' - 26;
+        constexpr char shift_digit = '0' - 52;
+        constexpr char shift_62 = static_cast<char>(static_cast<uint8_t>(simd_traits::char_62() - 62));
+        constexpr char shift_63 = static_cast<char>(static_cast<uint8_t>(simd_traits::char_63() - 63));
+
+        // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m256i ranges = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+        const __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets);
+        ranges = _mm256_or_si256(ranges, _mm256_and_si256(is_upper, _mm256_set1_epi8(13)));
+
+        const __m256i shifts = _mm256_setr_epi8(
+            shift_lower, shift_digit, shift_digit, shift_digit, shift_digit, shift_digit,
+            shift_digit, shift_digit, shift_digit, shift_digit, shift_digit, shift_62,
+            shift_63, shift_upper, 0, 0,
+            shift_lower, shift_digit, shift_digit, shift_digit, shift_digit, shift_digit,
+            shift_digit, shift_digit, shift_digit, shift_digit, shift_digit, shift_62,
+            shift_63, shift_upper, 0, 0);
+
+        return _mm256_add_epi8(_mm256_shuffle_epi8(shifts, ranges), sextets);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t encode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        // every 3 bytes of a 128-bit lane are spread into 4 bytes: [b1, b0, b2, b1]
+        const __m256i spread = _mm256_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+        // a step reads 28 bytes (12 bytes per lane using 16-byte loads) and consumes 24 of them
+        size_t i = 0;
+        for (; i + 28 <= src_size; i += 24, dst += 32)
+        {
+            const __m256i input = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(load_128(src + i)), load_128(src + i + 12), 1);
+
+            const __m256i words = _mm256_shuffle_epi8(input, spread);
+
+            // extract sextets a & c into bytes 0 & 2 and sextets b & d into bytes 1 & 3
+            const __m256i ac = _mm256_mulhi_epu16(
+                _mm256_and_si256(words, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+            const __m256i bd = _mm256_mullo_epi16(
+                _mm256_and_si256(words, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+
+            store_256(dst, sextets_to_symbols<encoding_traits>(_mm256_or_si256(ac, bd)));
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // converts 32 symbols to sextets, valid_mask gets 0xFF for every alphabetic symbol
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline __m256i symbols_to_sextets(__m256i symbols, __m256i & valid_mask) noexcept
+    {
+        using simd_traits = simd_traits_t<encoding_traits>;
+
+        constexpr char shift_upper = static_cast<char>(0 - 'A');
+        constexpr char shift_lower = static_cast<char>(26 - 'a');
+        constexpr char shift_digit = static_cast<char>(52 - '0');
+        constexpr char shift_62 = static_cast<char>(static_cast<uint8_t>(62 - simd_traits::char_62()));
+        constexpr char shift_63 = static_cast<char>(static_cast<uint8_t>(63 - simd_traits::char_63()));
+        constexpr char symbol_62 = static_cast<char>(simd_traits::char_62());
+        constexpr char symbol_63 = static_cast<char>(simd_traits::char_63());
+
+        // signed comparisons: symbols 0x80-0xFF are negative and fall out of all ranges
+        const __m256i is_upper = _mm256_and_si256(
+            _mm256_cmpgt_epi8(symbols, _mm256_set1_epi8('A' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), symbols));
+        const __m256i is_lower = _mm256_and_si256(
+            _mm256_cmpgt_epi8(symbols, _mm256_set1_epi8('a' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), symbols));
+        const __m256i is_digit = _mm256_and_si256(
+            _mm256_cmpgt_epi8(symbols, _mm256_set1_epi8('0' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), symbols));
+        const __m256i is_62 = _mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(symbol_62));
+        const __m256i is_63 = _mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(symbol_63));
+
+        valid_mask = _mm256_or_si256(
+            _mm256_or_si256(_mm256_or_si256(is_upper, is_lower), is_digit), _mm256_or_si256(is_62, is_63));
+
+        const __m256i shifts = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_and_si256(is_upper, _mm256_set1_epi8(shift_upper)),
+                _mm256_and_si256(is_lower, _mm256_set1_epi8(shift_lower))),
+            _mm256_or_si256(
+                _mm256_and_si256(is_digit, _mm256_set1_epi8(shift_digit)),
+                _mm256_or_si256(
+                    _mm256_and_si256(is_62, _mm256_set1_epi8(shift_62)),
+                    _mm256_and_si256(is_63, _mm256_set1_epi8(shift_63)))));
+
+        return _mm256_add_epi8(symbols, shifts);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t decode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        // 3 bytes of every 32-bit word are packed into 12 bytes at the start of each 128-bit lane
+        const __m256i pack = _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+        size_t i = 0;
+        for (; i + 32 <= src_size; i += 32, dst += 24)
+        {
+            __m256i valid_mask;
+            const __m256i sextets = symbols_to_sextets<encoding_traits>(load_256(src + i), valid_mask);
+
+            if (_mm256_movemask_epi8(valid_mask) != -1)
+                break;
+
+            // [a, b, c, d] -> [a << 6 | b, c << 6 | d] -> [a << 18 | b << 12 | c << 6 | d]
+            const __m256i pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+            const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+
+            const __m256i packed = _mm256_permutevar8x32_epi32(
+                _mm256_shuffle_epi8(words, pack), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+            store_128(dst, _mm256_castsi256_si128(packed));
+            store_64(dst + 16, _mm256_extracti128_si256(packed, 1));
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // 0xFF for every alphabetic symbol, the same checks as in symbols_to_sextets()
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline __m256i alphabetic_mask(__m256i symbols) noexcept
+    {
+        using simd_traits = simd_traits_t<encoding_traits>;
+
+        constexpr char symbol_62 = static_cast<char>(simd_traits::char_62());
+        constexpr char symbol_63 = static_cast<char>(simd_traits::char_63());
+
+        const __m256i is_upper = _mm256_and_si256(
+            _mm256_cmpgt_epi8(symbols, _mm256_set1_epi8('A' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), symbols));
+        const __m256i is_lower = _mm256_and_si256(
+            _mm256_cmpgt_epi8(symbols, _mm256_set1_epi8('a' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), symbols));
+        const __m256i is_digit = _mm256_and_si256(
+            _mm256_cmpgt_epi8(symbols, _mm256_set1_epi8('0' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), symbols));
+        const __m256i is_62 = _mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(symbol_62));
+        const __m256i is_63 = _mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(symbol_63));
+
+        return _mm256_or_si256(
+            _mm256_or_si256(_mm256_or_si256(is_upper, is_lower), is_digit), _mm256_or_si256(is_62, is_63));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t validate(const uint8_t * src, size_t src_size) noexcept
+    {
+        size_t i = 0;
+
+        // two blocks per step, a single check of the combined mask
+        for (; i + 64 <= src_size; i += 64)
+        {
+            const __m256i valid_mask = _mm256_and_si256(
+                alphabetic_mask<encoding_traits>(load_256(src + i)),
+                alphabetic_mask<encoding_traits>(load_256(src + i + 32)));
+
+            if (_mm256_movemask_epi8(valid_mask) != -1)
+                break;
+        }
+
+        for (; i + 32 <= src_size; i += 32)
+        {
+            if (_mm256_movemask_epi8(alphabetic_mask<encoding_traits>(load_256(src + i))) != -1)
+                break;
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t locate_invalid(const uint8_t * src, size_t src_size) noexcept
+    {
+        size_t i = 0;
+        for (; i + 32 <= src_size; i += 32)
+        {
+            const __m256i symbols = load_256(src + i);
+            __m256i valid_mask = alphabetic_mask<encoding_traits>(symbols);
+
+            if constexpr (encoding_traits::has_pad())
+            {
+                const char pad = static_cast<char>(encoding_traits::pad());
+                valid_mask = _mm256_or_si256(valid_mask, _mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(pad)));
+            }
+
+            const uint32_t invalid_bits = ~static_cast<uint32_t>(_mm256_movemask_epi8(valid_mask));
+
+            if (invalid_bits != 0)
+                return i + static_cast<size_t>(std::countr_zero(invalid_bits));
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          pos,
+        size_t          * positions,
+        size_t          max_count,
+        size_t          & count) noexcept
+    {
+        for (; pos + 32 <= src_size && count < max_count; pos += 32)
+        {
+            const __m256i symbols = load_256(src + pos);
+            __m256i valid_mask = alphabetic_mask<encoding_traits>(symbols);
+
+            if constexpr (encoding_traits::has_pad())
+            {
+                const char pad = static_cast<char>(encoding_traits::pad());
+                valid_mask = _mm256_or_si256(
+                    valid_mask, _mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(pad)));
+            }
+
+            uint32_t invalid_bits = ~static_cast<uint32_t>(_mm256_movemask_epi8(valid_mask));
+
+            // one index per set bit, the lowest bit is cleared on every step
+            for (; invalid_bits != 0 && count < max_count; invalid_bits &= invalid_bits - 1)
+                positions[count++] = pos + static_cast<size_t>(std::countr_zero(invalid_bits));
+        }
+
+        return pos;
+    }
+
+}   // namespace avx2
+}   // namespace detail
+}   // namespace base64
+
+#endif  // BASE64_HAS_AVX2
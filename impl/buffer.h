@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+
+namespace base64
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // buffer_t class declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // An owning byte buffer allocated once and left uninitialized (unlike std::vector), e.g. for
+    // decoding of large data:
+    //     buffer_t raw_data(calc_decoded_size(base64_data));
+    //     decode(base64_data, raw_data);
+
+    class buffer_t
+    {
+    public:
+        // the alignment of vector loads and stores, a cache line
+        static constexpr size_t simd_alignment = 64;
+
+        struct deleter_t
+        {
+            std::align_val_t alignment;
+            void operator()(uint8_t * data) const noexcept;
+        };
+
+        using pointer_t = std::unique_ptr<uint8_t[], deleter_t>;
+
+        buffer_t() noexcept = default;
+        ~buffer_t() noexcept = default;
+
+        // alignment must be a power of two
+        explicit buffer_t(size_t byte_count, size_t alignment = alignof(std::max_align_t));
+
+        buffer_t(buffer_t && other) noexcept;
+        buffer_t & operator=(buffer_t && other) noexcept;
+
+        void swap(buffer_t & other) noexcept;
+
+        uint8_t * data() noexcept;
+        const uint8_t * data() const noexcept;
+        size_t size() const noexcept;
+
+        // passes the ownership to the caller, the buffer becomes empty
+        pointer_t release() noexcept;
+
+    private:
+        pointer_t   m_data = pointer_t(nullptr, deleter_t{ std::align_val_t{ alignof(std::max_align_t) } });
+        size_t      m_size = 0;
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // buffer_t class definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline void buffer_t::deleter_t::operator()(uint8_t * data) const noexcept
+    {
+        ::operator delete[](data, alignment);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline buffer_t::buffer_t(size_t byte_count, size_t alignment)
+        : m_data(nullptr, deleter_t{ std::align_val_t{ alignment } })
+        , m_size(byte_count)
+    {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+        if (byte_count > 0)
+            m_data.reset(static_cast<uint8_t *>(::operator new[](byte_count, std::align_val_t{ alignment })));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline buffer_t::buffer_t(buffer_t && other) noexcept
+        : m_data(std::move(other.m_data))
+        , m_size(std::exchange(other.m_size, 0))
+    {
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline buffer_t & buffer_t::operator=(buffer_t && other) noexcept
+    {
+        buffer_t(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline void buffer_t::swap(buffer_t & other) noexcept
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline uint8_t * buffer_t::data() noexcept
+    {
+        return m_data.get();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline const uint8_t * buffer_t::data() const noexcept
+    {
+        return m_data.get();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline size_t buffer_t::size() const noexcept
+    {
+        return m_size;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline buffer_t::pointer_t buffer_t::release() noexcept
+    {
+        m_size = 0;
+        return std::move(m_data);
+    }
+
+}   // namespace base64
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "adapters.h"
+#include "allocators.h"
+#include "decode.h"
+#include "encode.h"
+#include "errors.h"
+#include "make_adapter.h"
+#include "validate.h"
+
+#include <functional>
+
+
+namespace base64
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // codec functions declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Adapter-based wrappers of encode_raw_impl(), decode_raw_impl() and validate_raw_impl()
+    // reporting errors with error_code_t.
+
+    template <typename encoding_traits>
+    error_code_t encode_impl(
+        const const_adapter_t       & raw_data,
+        const mutable_adapter_t     & base64_data);
+
+    // the buffer contains raw_size bytes of the raw data at its beginning
+    template <typename encoding_traits>
+    error_code_t encode_inplace_impl(
+        const mutable_adapter_t     & buffer,
+        size_t                      raw_size);
+
+    template <typename encoding_traits, decode_mode_t mode = decode_mode_t::lenient>
+    error_code_t decode_impl(
+        const const_adapter_t       & base64_data,
+        const mutable_adapter_t     & raw_data);
+
+    // raw_size receives the decoded size (on error, the size of the data decoded before the error)
+    template <typename encoding_traits>
+    error_code_t decode_inplace_impl(
+        const mutable_adapter_t     & base64_data,
+        size_t                      & raw_size);
+
+    template <typename encoding_traits>
+    error_code_t validate_impl(const const_adapter_t & base64_data);
+
+    // Allocating wrappers: the output is grown once by calc_encoded_size() or calc_decoded_size().
+    // base64_container is a string or a vector of bytes, the encoded data is appended to it.
+    // On a decoding error the vector keeps the data decoded before the error.
+    template <typename encoding_traits, typename base64_container>
+    void encode_append_impl(
+        const const_adapter_t       & raw_data,
+        base64_container            & base64_data);
+
+    template <typename encoding_traits, decode_mode_t mode = decode_mode_t::lenient, typename allocator_type>
+    error_code_t decode_to_vector_impl(
+        const const_adapter_t                   & base64_data,
+        std::vector<uint8_t, allocator_type>    & raw_data);
+
+
+namespace detail
+{
+    template <typename encoding_traits>
+    error_code_t make_decode_error(
+        const raw_result_t          & result,
+        const const_adapter_t       & base64_data,
+        size_t                      raw_size);
+
+}   // namespace detail
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // codec functions definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline error_code_t encode_impl(
+        const const_adapter_t       & raw_data,
+        const mutable_adapter_t     & base64_data)
+    {
+        const raw_result_t result = encode_raw_impl<encoding_traits>(
+            raw_data.data(), raw_data.size(), base64_data.data(), base64_data.size());
+
+        if (result.status == error_type_t::insufficient_buffer_size)
+        {
+            return detail::insufficient_buffer_size_error(
+                base64_data.size(), calc_encoded_size_impl<encoding_traits>(raw_data.size()));
+        }
+
+        return error_code_t{};
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline error_code_t encode_inplace_impl(
+        const mutable_adapter_t     & buffer,
+        size_t                      raw_size)
+    {
+        const raw_result_t result = encode_inplace_raw_impl<encoding_traits>(buffer.data(), raw_size, buffer.size());
+
+        if (result.status == error_type_t::insufficient_buffer_size)
+        {
+            return detail::insufficient_buffer_size_error(
+                buffer.size(), calc_encoded_size_impl<encoding_traits>(raw_size));
+        }
+
+        return error_code_t{};
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits, decode_mode_t mode>
+    inline error_code_t decode_impl(
+        const const_adapter_t       & base64_data,
+        const mutable_adapter_t     & raw_data)
+    {
+        const raw_result_t result = decode_raw_impl<encoding_traits, mode>(
+            base64_data.data(), base64_data.size(), raw_data.data(), raw_data.size());
+
+        return detail::make_decode_error<encoding_traits>(result, base64_data, raw_data.size());
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline error_code_t decode_inplace_impl(
+        const mutable_adapter_t     & base64_data,
+        size_t                      & raw_size)
+    {
+        const raw_result_t result = decode_inplace_raw_impl<encoding_traits>(
+            base64_data.data(), base64_data.size());
+
+        // the bad symbol (if any) isn't overwritten: the output stops before its quad
+        raw_size = result.written;
+        return detail::make_decode_error<encoding_traits>(
+            result, make_const_adapter(base64_data), base64_data.size());
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline error_code_t validate_impl(const const_adapter_t & base64_data)
+    {
+        const raw_result_t result = validate_raw_impl<encoding_traits>(base64_data.data(), base64_data.size());
+
+        switch (result.status)
+        {
+        case error_type_t::no_error:
+        case error_type_t::insufficient_buffer_size:
+        case error_type_t::misplaced_pad:
+        case error_type_t::non_canonical_trailing_bits:
+            break;
+
+        case error_type_t::invalid_buffer_size:
+            return detail::invalid_buffer_size_error<encoding_traits>(base64_data.size());
+
+        case error_type_t::non_alphabetic_symbol:
+            return detail::non_alphabetic_symbol_error(result.consumed, base64_data.data()[result.consumed]);
+        }
+
+        return error_code_t{};
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits, typename base64_container>
+    inline void encode_append_impl(
+        const const_adapter_t       & raw_data,
+        base64_container            & base64_data)
+    {
+        // The source may be the container itself (like std::string::append), its storage is
+        // reallocated by the growth, so the source is addressed by the offset then.
+        const auto * const container_ptr =
+            static_cast<const uint8_t *>(static_cast<const void *>(base64_data.data()));
+        const std::less<const uint8_t *> less;
+
+        const bool is_inside = raw_data.size() > 0
+            && !less(raw_data.data(), container_ptr)
+            && less(raw_data.data(), container_ptr + base64_data.size());
+        const size_t offset = is_inside ? static_cast<size_t>(raw_data.data() - container_ptr) : 0;
+
+        detail::append_overwrite(base64_data, calc_encoded_size_impl<encoding_traits>(raw_data.size()),
+            [&raw_data, is_inside, offset](uint8_t * data, size_t tail_pos, size_t tail_size)
+            {
+                const uint8_t * const raw_ptr = is_inside ? data + offset : raw_data.data();
+                return encode_raw_impl<encoding_traits>(
+                    raw_ptr, raw_data.size(), data + tail_pos, tail_size).written;
+            });
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits, decode_mode_t mode, typename allocator_type>
+    inline error_code_t decode_to_vector_impl(
+        const const_adapter_t                   & base64_data,
+        std::vector<uint8_t, allocator_type>    & raw_data)
+    {
+        if (!detail::check_base64_buffer_size<encoding_traits>(base64_data.size()))
+        {
+            raw_data.clear();
+            return detail::invalid_buffer_size_error<encoding_traits>(base64_data.size());
+        }
+
+        raw_data.resize(calc_decoded_size_impl<encoding_traits>(base64_data));
+
+        const raw_result_t result = decode_raw_impl<encoding_traits, mode>(
+            base64_data.data(), base64_data.size(), raw_data.data(), raw_data.size());
+
+        raw_data.resize(result.written);
+        return detail::make_decode_error<encoding_traits>(result, base64_data, raw_data.size());
+    }
+
+
+
+namespace detail
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline error_code_t make_decode_error(
+        const raw_result_t          & result,
+        const const_adapter_t       & base64_data,
+        size_t                      raw_size)
+    {
+        switch (result.status)
+        {
+        case error_type_t::no_error:
+            break;
+
+        case error_type_t::insufficient_buffer_size:
+            return insufficient_buffer_size_error(
+                raw_size, calc_decoded_size_impl<encoding_traits>(base64_data));
+
+        case error_type_t::invalid_buffer_size:
+            return invalid_buffer_size_error<encoding_traits>(base64_data.size());
+
+        case error_type_t::non_alphabetic_symbol:
+            return non_alphabetic_symbol_error(result.consumed, base64_data.data()[result.consumed]);
+
+        case error_type_t::misplaced_pad:
+            return misplaced_pad_error(result.consumed, base64_data.data()[result.consumed]);
+
+        case error_type_t::non_canonical_trailing_bits:
+            return non_canonical_trailing_bits_error(result.consumed, base64_data.data()[result.consumed]);
+        }
+
+        return error_code_t{};
+    }
+
+}   // namespace detail
+}   // namespace base64
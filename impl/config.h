@@ -0,0 +1,29 @@
+#pragma once
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// vector kernels configuration
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Define BASE64_DISABLE_SIMD to build the library without vector kernels
+// (e.g. for sanitizer builds or targets where intrinsics are not allowed).
+
+#if !defined(BASE64_DISABLE_SIMD) && \
+    (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#   define BASE64_X86 1
+#else
+#   define BASE64_X86 0
+#endif
+
+// Vector kernels are compiled for their own instruction sets regardless of the compiler flags
+// and are selected at runtime (see dispatch.h), so the library doesn't require -mavx2 etc.
+#define BASE64_HAS_AVX2 BASE64_X86
+#define BASE64_HAS_SSSE3 BASE64_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define BASE64_TARGET_AVX2 __attribute__((target("avx2")))
+#   define BASE64_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#   define BASE64_TARGET_AVX2
+#   define BASE64_TARGET_SSSE3
+#endif
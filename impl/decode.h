@@ -1,9 +1,12 @@
 #pragma once
 
 #include "adapters.h"
+#include "dispatch.h"
 #include "encoding_traits.h"
-#include "make_adapter.h"
+#include "result.h"
+#include "scalar.h"
 
+#include <algorithm>
 #include <cassert>
 
 
@@ -14,13 +17,40 @@ namespace base64
     // decode functions declaration
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
+    // The pads are subtracted only from complete quads, so a buffer of invalid size (e.g. "=")
+    // doesn't underflow the result.
     template <typename encoding_traits>
     size_t calc_decoded_size_impl(const const_adapter_t & base64_data) noexcept;
 
+    // strict: canonical input only, a pad is accepted only at the end of the last quad ("xx==" or
+    // "xxx=") and the unused bits of the last symbol must be zero
+    enum class decode_mode_t
+    {
+        lenient = 0,
+        strict
+    };
+
+
+    template <typename encoding_traits, decode_mode_t mode = decode_mode_t::lenient>
+    raw_result_t decode_raw_impl(
+        const uint8_t   * base64_ptr,
+        size_t          base64_size,
+        uint8_t         * raw_ptr,
+        size_t          raw_buffer_size) noexcept;
+
+    // In-place decoding: the output is written over the input starting at its beginning. It's
+    // safe because every kernel writes the output of a block only after the block has been read
+    // and 3 bytes per quad never overtake the input position.
+    template <typename encoding_traits>
+    raw_result_t decode_inplace_raw_impl(uint8_t * base64_ptr, size_t base64_size) noexcept;
+
+
+namespace detail
+{
     template <typename encoding_traits>
-    error_code_t decode_impl(
-        const const_adapter_t       & base64_data,
-        const mutable_adapter_t     & raw_data);
+    bool check_base64_buffer_size(size_t base64_buffer_size) noexcept;
+
+}   // namespace detail
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -36,7 +66,7 @@ namespace base64
 
         if constexpr (encoding_traits::has_pad())
         {
-            if (encoded_size > 0)
+            if (encoded_size >= 4 && encoded_size % 4 == 0)
             {
                 const uint8_t * base64_ptr = base64_data.data();
 
@@ -44,7 +74,7 @@ namespace base64
                 {
                     --raw_size;
 
-                    if (encoded_size > 1 && base64_ptr[encoded_size - 2] == encoding_traits::pad())
+                    if (base64_ptr[encoded_size - 2] == encoding_traits::pad())
                         --raw_size;
                 }
             }
@@ -59,30 +89,66 @@ namespace base64
     }
 
 
+namespace detail
+{
     ////////////////////////////////////////////////////////////////////////////////////////////////
     template <typename encoding_traits>
-    error_code_t decode_impl(
-        const const_adapter_t       & base64_data,
-        const mutable_adapter_t     & raw_data)
+    inline bool check_base64_buffer_size(size_t base64_buffer_size) noexcept
     {
-        const size_t raw_size = calc_decoded_size_impl<encoding_traits>(base64_data);
-        const size_t raw_buffer_size = raw_data.size();
-        const size_t base64_buffer_size = base64_data.size();
+        if constexpr (encoding_traits::has_pad())
+        {
+            return base64_buffer_size % 4 == 0;
+        }
+        else
+        {
+            const size_t tail_size = base64_buffer_size % 4;
+            return tail_size == 0 || tail_size == 2 || tail_size == 3;
+        }
+    }
+
+}   // namespace detail
 
-        if (raw_buffer_size < raw_size)
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits, decode_mode_t mode>
+    raw_result_t decode_raw_impl(
+        const uint8_t   * base64_ptr,
+        size_t          base64_size,
+        uint8_t         * raw_ptr,
+        size_t          raw_buffer_size) noexcept
+    {
+        constexpr bool strict = mode == decode_mode_t::strict;
+
+        // the padding is scanned only if the buffer is shorter than the upper bound of the size
+        const size_t max_raw_size = encoding_traits::has_pad()
+            ? 3 * (base64_size / 4)
+            : calc_decoded_size_impl<encoding_traits>(const_adapter_t(base64_ptr, base64_size));
+
+        if (raw_buffer_size < max_raw_size &&
+            raw_buffer_size < calc_decoded_size_impl<encoding_traits>(const_adapter_t(base64_ptr, base64_size)))
         {
-            return detail::insufficient_buffer_size_error(raw_buffer_size, raw_size);
+            return raw_result_t{ error_type_t::insufficient_buffer_size, 0, 0 };
         }
 
-        if (!detail::check_base64_buffer_size<encoding_traits>(base64_buffer_size))
+        if (!detail::check_base64_buffer_size<encoding_traits>(base64_size))
         {
-            return detail::invalid_buffer_size_error<encoding_traits>(base64_buffer_size);
+            return raw_result_t{ error_type_t::invalid_buffer_size, 0, 0 };
         }
 
-        error_code_t err_code;
-        const uint8_t * base64_ptr = base64_data.data();
+        raw_result_t result;
+
+        // only the first error (by position) is reported: the checks of the last quad aren't
+        // done in the order of the symbols
+        auto set_error = [& result](error_type_t type, size_t pos)
+        {
+            if (result.status == error_type_t::no_error || pos < result.consumed)
+            {
+                result.status = type;
+                result.consumed = pos;
+            }
+        };
 
-        auto index_of = [base64_ptr, & err_code](size_t pos) -> uint32_t
+        auto index_of = [base64_ptr, & set_error](size_t pos) -> uint32_t
         {
             const uint8_t symbol = base64_ptr[pos];
 
@@ -96,9 +162,7 @@ namespace base64
 
             if (index == encoding_traits::invalid_index())
             {
-                if (!err_code)
-                    err_code = detail::non_alphabetic_symbol_error(pos, symbol);
-
+                set_error(error_type_t::non_alphabetic_symbol, pos);
                 return 0;
             }
 
@@ -110,12 +174,57 @@ namespace base64
             return (sextet_a << 3 * 6) + (sextet_b << 2 * 6) + (sextet_c << 1 * 6) + (sextet_d << 0 * 6);
         };
 
-        const size_t encoded_size = 4 * (base64_buffer_size / 4);
-        uint8_t * raw_ptr = raw_data.data();
+        const size_t encoded_size = 4 * (base64_size / 4);
+
+        // only the last quad may contain a pad, every other one decodes into 3 bytes
+        const size_t body_size =
+            encoding_traits::has_pad() && encoded_size > 0 ? encoded_size - 4 : encoded_size;
 
-        size_t raw_pos = 0;
-        for (size_t i = 0; i < encoded_size && !err_code;)
+        size_t i = detail::decode_kernel<encoding_traits>(base64_ptr, body_size, raw_ptr);
+
+        i += detail::scalar::decode<encoding_traits>(
+            base64_ptr + i, body_size - i, raw_ptr + 3 * (i / 4));
+
+        // main loop: full quads, 3 bytes each; when the table-driven loop rejects a quad, the
+        // first bad symbol is located with the vector kernel: a quad preceding it contains a pad,
+        // which decodes as zero (or is an error in the strict mode)
+        size_t checked_end = 0;     // there are no bad symbols before this position
+
+        while (i < body_size)
         {
+            i += detail::scalar::decode_quads<encoding_traits>(
+                base64_ptr + i, (body_size - i) / 4, raw_ptr + 3 * (i / 4));
+
+            if (i == body_size)
+                break;
+
+            if (checked_end <= i)
+                checked_end = i + detail::locate_invalid<encoding_traits>(base64_ptr + i, base64_size - i);
+
+            if constexpr (strict && encoding_traits::has_pad())
+            {
+                // a pad preceding the non-alphabetic symbol (if any) is the first error
+                const size_t quad_end = std::min(checked_end, i + 4);
+
+                size_t pad_pos = i;
+                while (pad_pos < quad_end && base64_ptr[pad_pos] != encoding_traits::pad())
+                    ++pad_pos;
+
+                if (pad_pos < quad_end)
+                {
+                    set_error(error_type_t::misplaced_pad, pad_pos);
+                    break;
+                }
+            }
+
+            if (checked_end < i + 4)
+            {
+                set_error(error_type_t::non_alphabetic_symbol, checked_end);
+                break;
+            }
+
+            uint8_t * dst = raw_ptr + 3 * (i / 4);
+
             const uint32_t sextet_a = index_of(i++);
             const uint32_t sextet_b = index_of(i++);
             const uint32_t sextet_c = index_of(i++);
@@ -123,40 +232,104 @@ namespace base64
 
             const uint32_t triple = calc_triple(sextet_a, sextet_b, sextet_c, sextet_d);
 
-            assert(raw_pos < raw_size);
-            raw_ptr[raw_pos++] = (triple >> 2 * 8) & 0xFF;
+            dst[0] = (triple >> 2 * 8) & 0xFF;
+            dst[1] = (triple >> 1 * 8) & 0xFF;
+            dst[2] = (triple >> 0 * 8) & 0xFF;
+        }
+
+        size_t raw_pos = 3 * (body_size / 4);
+
+        // the last (padded) quad decodes into 1-3 bytes
+        if constexpr (encoding_traits::has_pad())
+        {
+            if (encoded_size > 0 && result.status == error_type_t::no_error)
+            {
+                size_t quad_pos = body_size;
+
+                const uint32_t sextet_a = index_of(quad_pos++);
+                const uint32_t sextet_b = index_of(quad_pos++);
+                const uint32_t sextet_c = index_of(quad_pos++);
+                const uint32_t sextet_d = index_of(quad_pos);
+
+                const uint32_t triple = calc_triple(sextet_a, sextet_b, sextet_c, sextet_d);
+
+                const bool pad_d = base64_ptr[encoded_size - 1] == encoding_traits::pad();
+                const bool pad_c = pad_d && base64_ptr[encoded_size - 2] == encoding_traits::pad();
+
+                if constexpr (strict)
+                {
+                    // "xxxx", "xxx=" or "xx==", the bits of the skipped byte(s) must be zero
+                    if (base64_ptr[body_size] == encoding_traits::pad())
+                        set_error(error_type_t::misplaced_pad, body_size);
+                    else if (base64_ptr[body_size + 1] == encoding_traits::pad())
+                        set_error(error_type_t::misplaced_pad, body_size + 1);
+                    else if (!pad_d && base64_ptr[body_size + 2] == encoding_traits::pad())
+                        set_error(error_type_t::misplaced_pad, body_size + 2);
+                    else if ((triple & (pad_c ? 0xFFFF : pad_d ? 0xFF : 0)) != 0)
+                        set_error(error_type_t::non_canonical_trailing_bits, pad_c ? body_size + 1 : body_size + 2);
+                }
+
+                raw_ptr[raw_pos++] = (triple >> 2 * 8) & 0xFF;
 
-            if (raw_pos < raw_size)
-                raw_ptr[raw_pos++] = (triple >> 1 * 8) & 0xFF;
+                if (!pad_c)
+                    raw_ptr[raw_pos++] = (triple >> 1 * 8) & 0xFF;
 
-            if (raw_pos < raw_size)
-                raw_ptr[raw_pos++] = (triple >> 0 * 8) & 0xFF;
+                if (!pad_d)
+                    raw_ptr[raw_pos++] = (triple >> 0 * 8) & 0xFF;
+            }
         }
 
+        // the unpadded tail decodes into 1-2 bytes
         if constexpr (!encoding_traits::has_pad())
         {
-            const size_t tail_size = base64_buffer_size - encoded_size;
+            const size_t tail_size = base64_size - encoded_size;
             assert(tail_size == 0 || tail_size == 2 || tail_size == 3);
 
-            if (tail_size > 0 && !err_code)
+            if (tail_size > 0 && result.status == error_type_t::no_error)
             {
                 size_t tail_pos = encoded_size;
 
                 const uint32_t sextet_a = index_of(tail_pos++);
-                const uint32_t sextet_b = tail_size > 1 ? index_of(tail_pos++) : 0;
+                const uint32_t sextet_b = index_of(tail_pos++);
                 const uint32_t sextet_c = tail_size > 2 ? index_of(tail_pos) : 0;
 
                 const uint32_t triple = calc_triple(sextet_a, sextet_b, sextet_c, 0);
 
-                assert(raw_pos < raw_size);
+                if constexpr (strict)
+                {
+                    // the bits of the skipped byte(s) must be zero
+                    if ((triple & (tail_size == 2 ? 0xFFFF : 0xFF)) != 0)
+                        set_error(error_type_t::non_canonical_trailing_bits, encoded_size + tail_size - 1);
+                }
+
                 raw_ptr[raw_pos++] = (triple >> 2 * 8) & 0xFF;
-                
-                if (raw_pos < raw_size)
+
+                if (tail_size > 2)
                     raw_ptr[raw_pos++] = (triple >> 1 * 8) & 0xFF;
             }
         }
 
-        return err_code;
+        if (result.status != error_type_t::no_error)
+        {
+            // only the quads preceding the bad symbol are decoded
+            result.written = 3 * (result.consumed / 4);
+            return result;
+        }
+
+        assert(raw_pos <= raw_buffer_size);
+
+        result.consumed = base64_size;
+        result.written = raw_pos;
+        return result;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline raw_result_t decode_inplace_raw_impl(uint8_t * base64_ptr, size_t base64_size) noexcept
+    {
+        // the input size is always sufficient for the output
+        return decode_raw_impl<encoding_traits>(base64_ptr, base64_size, base64_ptr, base64_size);
     }
 
 }   // namespace base64
@@ -0,0 +1,540 @@
+#pragma once
+
+#include "avx2.h"
+#include "config.h"
+#include "scalar.h"
+#include "simd_traits.h"
+#include "ssse3.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#if BASE64_X86
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#       include <immintrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif
+
+
+namespace base64
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // kernel_t enum definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    enum class kernel_t
+    {
+        scalar = 0,
+        ssse3,
+        avx2,
+        scalar_x4       // unrolled scalar code, 4 independent groups per step
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // kernel selection functions declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // The kernel is selected once on the first call: the best one supported by the CPU (scalar_x4
+    // if there is no vector kernel), unless the BASE64_FORCE_KERNEL environment variable names
+    // another supported kernel (scalar, scalar_x4, ssse3 or avx2).
+    kernel_t active_kernel() noexcept;
+
+    bool is_kernel_supported(kernel_t kernel) noexcept;
+
+    // Overrides the selected kernel (e.g. for testing and benchmarking).
+    // Returns false (and keeps the current kernel) if the kernel isn't supported.
+    bool set_kernel(kernel_t kernel) noexcept;
+
+
+namespace detail
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // dispatch helpers declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    struct cpu_features_t
+    {
+        bool ssse3 = false;
+        bool avx2 = false;
+    };
+
+    cpu_features_t detect_cpu_features() noexcept;
+    const cpu_features_t & cpu_features() noexcept;
+    kernel_t select_kernel() noexcept;
+
+    // Vector kernels process the longest prefix they can handle and return its size,
+    // the remaining data is processed by the scalar code.
+    using kernel_fn = size_t (*)(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+    using kernel_table_t = std::array<kernel_fn, 4>;   // indexed by kernel_t
+
+    // Validation kernels check the longest prefix they can handle and return its size.
+    using scan_kernel_fn = size_t (*)(const uint8_t * src, size_t src_size) noexcept;
+    using scan_kernel_table_t = std::array<scan_kernel_fn, 4>;
+
+    // Collecting kernels store the indexes of the invalid symbols in the complete blocks of
+    // [pos, src_size) and return the end of the scanned blocks (see ssse3::collect_invalid).
+    using collect_kernel_fn = size_t (*)(const uint8_t * src, size_t src_size, size_t pos,
+        size_t * positions, size_t max_count, size_t & count) noexcept;
+    using collect_kernel_table_t = std::array<collect_kernel_fn, 4>;
+
+    // Vector kernels are used only for alphabets with the standard layout (see simd_traits_t),
+    // the scalar kernels support any alphabet.
+    template <typename encoding_traits>
+    constexpr kernel_table_t make_encode_kernels() noexcept;
+
+    template <typename encoding_traits>
+    constexpr kernel_table_t make_decode_kernels() noexcept;
+
+    template <typename encoding_traits>
+    constexpr scan_kernel_table_t make_validate_kernels() noexcept;
+
+    template <typename encoding_traits>
+    constexpr scan_kernel_table_t make_locate_kernels() noexcept;
+
+    template <typename encoding_traits>
+    constexpr collect_kernel_table_t make_collect_kernels() noexcept;
+
+    template <typename encoding_traits>
+    size_t encode_kernel(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    template <typename encoding_traits>
+    size_t decode_kernel(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    template <typename encoding_traits>
+    size_t validate_kernel(const uint8_t * src, size_t src_size) noexcept;
+
+    // Returns the index of the first symbol which is neither alphabetic nor a pad (src_size if
+    // there is no such symbol): the vector kernel finds it in the complete blocks, the scalar
+    // code checks the rest.
+    template <typename encoding_traits>
+    size_t locate_invalid(const uint8_t * src, size_t src_size) noexcept;
+
+    // Stores the indexes of the symbols which are neither alphabetic nor a pad in ascending order,
+    // at most max_count of them, and returns their number. The kernel is dispatched once for the
+    // whole data: it walks the bits of every block mask, the scalar code collects in the rest.
+    template <typename encoding_traits>
+    size_t collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          * positions,
+        size_t          max_count) noexcept;
+
+    // -1 until the kernel is selected
+    inline std::atomic<int> selected_kernel{ -1 };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // dispatch helpers definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline cpu_features_t detect_cpu_features() noexcept
+    {
+        cpu_features_t features;
+
+#if BASE64_X86
+        uint32_t regs[4] = {};  // eax, ebx, ecx, edx
+
+        const auto cpuid = [&regs](uint32_t leaf) -> bool
+        {
+#   if defined(_MSC_VER)
+            int max_regs[4] = {};
+            __cpuid(max_regs, static_cast<int>(leaf & 0x80000000u));
+            if (static_cast<uint32_t>(max_regs[0]) < leaf)
+                return false;
+
+            int info[4] = {};
+            __cpuidex(info, static_cast<int>(leaf), 0);
+            for (size_t i = 0; i < 4; ++i)
+                regs[i] = static_cast<uint32_t>(info[i]);
+
+            return true;
+#   else
+            return __get_cpuid_count(leaf, 0, &regs[0], &regs[1], &regs[2], &regs[3]) != 0;
+#   endif
+        };
+
+        if (!cpuid(1))
+            return features;
+
+        constexpr uint32_t ssse3_bit = 1u << 9;
+        constexpr uint32_t osxsave_bit = 1u << 27;
+        constexpr uint32_t avx_bit = 1u << 28;
+
+        features.ssse3 = (regs[2] & ssse3_bit) != 0;
+
+        // AVX registers are usable only if the OS saves them on context switches
+        if ((regs[2] & osxsave_bit) == 0 || (regs[2] & avx_bit) == 0)
+            return features;
+
+#   if defined(_MSC_VER)
+        const uint64_t xcr0 = _xgetbv(0);
+#   else
+        uint32_t xcr0_lo = 0;
+        uint32_t xcr0_hi = 0;
+        __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+        const uint64_t xcr0 = (uint64_t{ xcr0_hi } << 32) | xcr0_lo;
+#   endif
+
+        constexpr uint64_t xmm_ymm_state = 0x06;
+        if ((xcr0 & xmm_ymm_state) != xmm_ymm_state)
+            return features;
+
+        constexpr uint32_t avx2_bit = 1u << 5;
+        features.avx2 = cpuid(7) && (regs[1] & avx2_bit) != 0;
+#endif
+
+        return features;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline const cpu_features_t & cpu_features() noexcept
+    {
+        static const cpu_features_t features = detect_cpu_features();
+        return features;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline kernel_t select_kernel() noexcept
+    {
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable: 4996)   // 'getenv': This function or variable may be unsafe
+#endif
+        const char * forced_name = std::getenv("BASE64_FORCE_KERNEL");
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
+
+        if (forced_name != nullptr)
+        {
+            const std::string_view name{ forced_name };
+            const kernel_t forced_kernel =
+                name == "avx2" ? kernel_t::avx2 :
+                name == "ssse3" ? kernel_t::ssse3 :
+                name == "scalar_x4" ? kernel_t::scalar_x4 : kernel_t::scalar;
+
+            const bool known_name = name == "scalar" || forced_kernel != kernel_t::scalar;
+
+            if (known_name && is_kernel_supported(forced_kernel))
+                return forced_kernel;
+        }
+
+        if (is_kernel_supported(kernel_t::avx2))
+            return kernel_t::avx2;
+
+        if (is_kernel_supported(kernel_t::ssse3))
+            return kernel_t::ssse3;
+
+        // no vector kernel (non-x86 CPU or BASE64_DISABLE_SIMD): the unrolled scalar code
+        return kernel_t::scalar_x4;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline size_t no_kernel(const uint8_t *, size_t, uint8_t *) noexcept
+    {
+        return 0;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline size_t no_scan_kernel(const uint8_t *, size_t) noexcept
+    {
+        return 0;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline size_t no_collect_kernel(
+        const uint8_t *, size_t, size_t pos, size_t *, size_t, size_t &) noexcept
+    {
+        return pos;
+    }
+
+
+#if BASE64_X86
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // the SSSE3 kernel handles the part of the tail that is too short for the AVX2 kernel
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t avx2_ssse3_encode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        const size_t i = avx2::encode<encoding_traits>(src, src_size, dst);
+        return i + ssse3::encode<encoding_traits>(src + i, src_size - i, dst + 4 * (i / 3));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t avx2_ssse3_decode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        const size_t i = avx2::decode<encoding_traits>(src, src_size, dst);
+        return i + ssse3::decode<encoding_traits>(src + i, src_size - i, dst + 3 * (i / 4));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t avx2_ssse3_validate(const uint8_t * src, size_t src_size) noexcept
+    {
+        const size_t i = avx2::validate<encoding_traits>(src, src_size);
+        return i + ssse3::validate<encoding_traits>(src + i, src_size - i);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t avx2_ssse3_locate_invalid(const uint8_t * src, size_t src_size) noexcept
+    {
+        // if the AVX2 kernel stops at an invalid symbol, the SSSE3 kernel returns 0
+        const size_t i = avx2::locate_invalid<encoding_traits>(src, src_size);
+        return i + ssse3::locate_invalid<encoding_traits>(src + i, src_size - i);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_AVX2
+    inline size_t avx2_ssse3_collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          pos,
+        size_t          * positions,
+        size_t          max_count,
+        size_t          & count) noexcept
+    {
+        // the SSSE3 kernel scans the last 16-symbol block left by the AVX2 one
+        pos = avx2::collect_invalid<encoding_traits>(
+            src, src_size, pos, positions, max_count, count);
+        return ssse3::collect_invalid<encoding_traits>(
+            src, src_size, pos, positions, max_count, count);
+    }
+#endif
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    constexpr kernel_table_t make_encode_kernels() noexcept
+    {
+        kernel_table_t kernels = {
+            &no_kernel,                             // scalar: the caller runs the scalar code
+            &no_kernel,
+            &no_kernel,
+            &scalar::encode_x4<encoding_traits>
+        };
+
+#if BASE64_X86
+        if constexpr (simd_traits_t<encoding_traits>::supported())
+        {
+            kernels[static_cast<int>(kernel_t::ssse3)] = &ssse3::encode<encoding_traits>;
+            kernels[static_cast<int>(kernel_t::avx2)] = &avx2_ssse3_encode<encoding_traits>;
+        }
+#endif
+
+        return kernels;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    constexpr kernel_table_t make_decode_kernels() noexcept
+    {
+        kernel_table_t kernels = {
+            &no_kernel,                             // scalar: the caller runs the scalar code
+            &no_kernel,
+            &no_kernel,
+            &scalar::decode_x4<encoding_traits>
+        };
+
+#if BASE64_X86
+        if constexpr (simd_traits_t<encoding_traits>::supported())
+        {
+            kernels[static_cast<int>(kernel_t::ssse3)] = &ssse3::decode<encoding_traits>;
+            kernels[static_cast<int>(kernel_t::avx2)] = &avx2_ssse3_decode<encoding_traits>;
+        }
+#endif
+
+        return kernels;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    constexpr scan_kernel_table_t make_validate_kernels() noexcept
+    {
+        // scalar kernels: the caller runs the scalar code
+        scan_kernel_table_t kernels = { &no_scan_kernel, &no_scan_kernel, &no_scan_kernel, &no_scan_kernel };
+
+#if BASE64_X86
+        if constexpr (simd_traits_t<encoding_traits>::supported())
+        {
+            kernels[static_cast<int>(kernel_t::ssse3)] = &ssse3::validate<encoding_traits>;
+            kernels[static_cast<int>(kernel_t::avx2)] = &avx2_ssse3_validate<encoding_traits>;
+        }
+#endif
+
+        return kernels;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    constexpr scan_kernel_table_t make_locate_kernels() noexcept
+    {
+        scan_kernel_table_t kernels = { &no_scan_kernel, &no_scan_kernel, &no_scan_kernel, &no_scan_kernel };
+
+#if BASE64_X86
+        if constexpr (simd_traits_t<encoding_traits>::supported())
+        {
+            kernels[static_cast<int>(kernel_t::ssse3)] = &ssse3::locate_invalid<encoding_traits>;
+            kernels[static_cast<int>(kernel_t::avx2)] = &avx2_ssse3_locate_invalid<encoding_traits>;
+        }
+#endif
+
+        return kernels;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    constexpr collect_kernel_table_t make_collect_kernels() noexcept
+    {
+        collect_kernel_table_t kernels = {
+            &no_collect_kernel, &no_collect_kernel, &no_collect_kernel, &no_collect_kernel };
+
+#if BASE64_X86
+        if constexpr (simd_traits_t<encoding_traits>::supported())
+        {
+            kernels[static_cast<int>(kernel_t::ssse3)] = &ssse3::collect_invalid<encoding_traits>;
+            kernels[static_cast<int>(kernel_t::avx2)] =
+                &avx2_ssse3_collect_invalid<encoding_traits>;
+        }
+#endif
+
+        return kernels;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t encode_kernel(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        static constexpr kernel_table_t kernels = make_encode_kernels<encoding_traits>();
+        return kernels[static_cast<int>(active_kernel())](src, src_size, dst);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t decode_kernel(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        static constexpr kernel_table_t kernels = make_decode_kernels<encoding_traits>();
+        return kernels[static_cast<int>(active_kernel())](src, src_size, dst);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t validate_kernel(const uint8_t * src, size_t src_size) noexcept
+    {
+        static constexpr scan_kernel_table_t kernels = make_validate_kernels<encoding_traits>();
+        return kernels[static_cast<int>(active_kernel())](src, src_size);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t locate_invalid(const uint8_t * src, size_t src_size) noexcept
+    {
+        static constexpr scan_kernel_table_t kernels = make_locate_kernels<encoding_traits>();
+
+        const size_t i = kernels[static_cast<int>(active_kernel())](src, src_size);
+        return i + scalar::locate_invalid<encoding_traits>(src + i, src_size - i);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          * positions,
+        size_t          max_count) noexcept
+    {
+        static constexpr collect_kernel_table_t kernels = make_collect_kernels<encoding_traits>();
+
+        size_t count = 0;
+        const collect_kernel_fn kernel = kernels[static_cast<int>(active_kernel())];
+        const size_t pos = kernel(src, src_size, 0, positions, max_count, count);
+        scalar::collect_invalid<encoding_traits>(src, src_size, pos, positions, max_count, count);
+
+        return count;
+    }
+
+}   // namespace detail
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // kernel selection functions definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline kernel_t active_kernel() noexcept
+    {
+        int kernel = detail::selected_kernel.load(std::memory_order_relaxed);
+
+        if (kernel < 0)
+        {
+            // concurrent first calls select the same kernel, so the race is benign
+            kernel = static_cast<int>(detail::select_kernel());
+            detail::selected_kernel.store(kernel, std::memory_order_relaxed);
+        }
+
+        return static_cast<kernel_t>(kernel);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline bool is_kernel_supported(kernel_t kernel) noexcept
+    {
+        switch (kernel)
+        {
+        case kernel_t::scalar:
+        case kernel_t::scalar_x4:
+            return true;
+
+        case kernel_t::ssse3:
+            return BASE64_HAS_SSSE3 && detail::cpu_features().ssse3;
+
+        case kernel_t::avx2:
+            return BASE64_HAS_AVX2 && detail::cpu_features().avx2 && detail::cpu_features().ssse3;
+        }
+
+        return false;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline bool set_kernel(kernel_t kernel) noexcept
+    {
+        if (!is_kernel_supported(kernel))
+            return false;
+
+        detail::selected_kernel.store(static_cast<int>(kernel), std::memory_order_relaxed);
+        return true;
+    }
+
+}   // namespace base64
@@ -1,10 +1,10 @@
 #pragma once
 
 
-#include "adapters.h"
+#include "dispatch.h"
 #include "encoding_traits.h"
-#include "errors.h"
-#include "make_adapter.h"
+#include "result.h"
+#include "scalar.h"
 
 #include <cassert>
 
@@ -20,9 +20,31 @@ namespace base64
     size_t calc_encoded_size_impl(size_t raw_size) noexcept;
 
     template <typename encoding_traits>
-    error_code_t encode_impl(
-        const const_adapter_t       & raw_data,
-        const mutable_adapter_t     & base64_data);
+    raw_result_t encode_raw_impl(
+        const uint8_t   * raw_ptr,
+        size_t          raw_size,
+        uint8_t         * base64_ptr,
+        size_t          base64_size) noexcept;
+
+    // In-place encoding: the raw data at the beginning of the buffer is replaced by its encoding.
+    // The data grows, so the buffer is processed from the end: the last quarter of the remaining
+    // triples is encoded forward by the kernels (its output lies entirely behind its input), and
+    // the first few triples are encoded backwards one by one.
+    template <typename encoding_traits>
+    raw_result_t encode_inplace_raw_impl(
+        uint8_t         * buffer_ptr,
+        size_t          raw_size,
+        size_t          buffer_size) noexcept;
+
+
+namespace detail
+{
+    // Encodes src_size bytes (a multiple of 3) with the kernels, the SWAR encoder and the
+    // byte-wise encoder, in that order.
+    template <typename encoding_traits>
+    void encode_body(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+}   // namespace detail
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -47,52 +69,103 @@ namespace base64
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     template <typename encoding_traits>
-    error_code_t encode_impl(
-        const const_adapter_t       & raw_data,
-        const mutable_adapter_t     & base64_data)
+    raw_result_t encode_raw_impl(
+        const uint8_t   * raw_ptr,
+        size_t          raw_size,
+        uint8_t         * base64_ptr,
+        size_t          base64_size) noexcept
     {
-        const size_t raw_size = raw_data.size();
         const size_t encoded_size = calc_encoded_size_impl<encoding_traits>(raw_size);
-        const size_t base64_size = base64_data.size();
 
         if (base64_size < encoded_size)
         {
-            return detail::insufficient_buffer_size_error(base64_size, encoded_size);
+            return raw_result_t{ error_type_t::insufficient_buffer_size, 0, 0 };
         }
 
-        const uint8_t * raw_ptr = raw_data.data();
-        uint8_t * base64_ptr = base64_data.data();
+        const size_t i = raw_size - raw_size % 3;
+        detail::encode_body<encoding_traits>(raw_ptr, i, base64_ptr);
 
-        for (size_t i = 0, j = 0; i < raw_size;)
+        // epilogue: the last 1 or 2 bytes and the padding
+        if (i < raw_size)
         {
-            uint32_t octet_a = i < raw_size ? raw_ptr[i++] : uint8_t{ 0 };
-            uint32_t octet_b = i < raw_size ? raw_ptr[i++] : uint8_t{ 0 };
-            uint32_t octet_c = i < raw_size ? raw_ptr[i++] : uint8_t{ 0 };
+            detail::scalar::encode_tail<encoding_traits>(
+                raw_ptr + i, raw_size - i, base64_ptr + 4 * (i / 3));
+        }
+
+        return raw_result_t{ error_type_t::no_error, raw_size, encoded_size };
+    }
+
 
-            uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    raw_result_t encode_inplace_raw_impl(
+        uint8_t         * buffer_ptr,
+        size_t          raw_size,
+        size_t          buffer_size) noexcept
+    {
+        const size_t encoded_size = calc_encoded_size_impl<encoding_traits>(raw_size);
 
-            base64_ptr[j++] = encoding_traits::char_at((triple >> 3 * 6) & 0x3F);
-            base64_ptr[j++] = encoding_traits::char_at((triple >> 2 * 6) & 0x3F);
-            base64_ptr[j++] = encoding_traits::char_at((triple >> 1 * 6) & 0x3F);
-            base64_ptr[j++] = encoding_traits::char_at((triple >> 0 * 6) & 0x3F);
+        if (buffer_size < encoded_size)
+        {
+            return raw_result_t{ error_type_t::insufficient_buffer_size, 0, 0 };
         }
 
-        if constexpr (encoding_traits::has_pad())
+        size_t triple_count = raw_size / 3;
+
+        // the last 1 or 2 bytes are copied first: their output may overlap them
+        if (const size_t tail_size = raw_size % 3; tail_size > 0)
         {
-            const size_t tail_size = raw_size % 3;
+            const uint8_t tail[2] = {
+                buffer_ptr[3 * triple_count],
+                tail_size > 1 ? buffer_ptr[3 * triple_count + 1] : uint8_t{ 0 } };
 
-            if (tail_size == 2)
-            {
-                base64_ptr[encoded_size - 1] = encoding_traits::pad();
-            }
-            else if (tail_size == 1)
-            {
-                base64_ptr[encoded_size - 1] = encoding_traits::pad();
-                base64_ptr[encoded_size - 2] = encoding_traits::pad();
-            }
+            detail::scalar::encode_tail<encoding_traits>(tail, tail_size, buffer_ptr + 4 * triple_count);
         }
 
-        return error_code_t{};
+        // chunk_start >= 3 / 4 * triple_count, so the chunk output starts behind its input end
+        constexpr size_t min_chunk_triples = 16;
+
+        while (triple_count >= 4 * min_chunk_triples)
+        {
+            const size_t chunk_start = triple_count - triple_count / 4;
+
+            detail::encode_body<encoding_traits>(
+                buffer_ptr + 3 * chunk_start, 3 * (triple_count - chunk_start), buffer_ptr + 4 * chunk_start);
+
+            triple_count = chunk_start;
+        }
+
+        while (triple_count > 0)
+        {
+            --triple_count;
+
+            const uint8_t triple[3] = {
+                buffer_ptr[3 * triple_count],
+                buffer_ptr[3 * triple_count + 1],
+                buffer_ptr[3 * triple_count + 2] };
+
+            detail::scalar::encode_triples<encoding_traits>(triple, 1, buffer_ptr + 4 * triple_count);
+        }
+
+        return raw_result_t{ error_type_t::no_error, raw_size, encoded_size };
+    }
+
+
+
+namespace detail
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline void encode_body(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        assert(src_size % 3 == 0);
+
+        size_t i = encode_kernel<encoding_traits>(src, src_size, dst);
+        i += scalar::encode<encoding_traits>(src + i, src_size - i, dst + 4 * (i / 3));
+
+        // complete triples only
+        scalar::encode_triples<encoding_traits>(src + i, (src_size - i) / 3, dst + 4 * (i / 3));
     }
 
+}   // namespace detail
 }   // namespace base64
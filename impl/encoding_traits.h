@@ -1,10 +1,10 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <limits>
 #include <string_view>
-#include <vector>
 
 
 namespace base64
@@ -29,20 +29,22 @@ namespace base64
             return static_cast<uint8_t>(alphabet_type[index]);
         }
 
-        static uint32_t index_of(uint8_t symbol)
+        static uint32_t index_of(uint8_t symbol) noexcept
         {
-            const auto make_indexes = []() -> std::vector<uint32_t>
-            {
-                std::vector<uint32_t> indexes(256, invalid_index());
+            // constant initialization: no guard check and no heap indirection on lookups
+            static constinit const std::array<uint8_t, 256> indexes = make_indexes();
+            return indexes[symbol];
+        }
 
-                for (uint32_t i = 0; i < alphabet_size(); ++i)
-                    indexes[char_at(i)] = i;
+        static constexpr std::array<uint8_t, 256> make_indexes() noexcept
+        {
+            std::array<uint8_t, 256> indexes{};
+            indexes.fill(static_cast<uint8_t>(invalid_index()));
 
-                return indexes;
-            };
+            for (uint32_t i = 0; i < alphabet_size(); ++i)
+                indexes[char_at(i)] = static_cast<uint8_t>(i);
 
-            static const std::vector<uint32_t> indexes = make_indexes();
-            return indexes[symbol];
+            return indexes;
         }
 
         static_assert(alphabet_size() == 64, "The BASE64 alphabet must be 64 characters long.");
@@ -73,8 +75,8 @@ namespace base64
 
         static uint32_t index_of(const uint8_t symbol) noexcept
         {
-            static constinit const uint32_t ii = invalid_index();
-            static constinit const uint32_t indexes[] = {
+            static constinit const uint8_t ii = invalid_index();
+            static constinit const uint8_t indexes[] = {
                  ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, //   0-15
                  ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, //  16-31
                  ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, 62, ii, ii, ii, 63, //  32-47
@@ -121,8 +123,8 @@ namespace base64
 
         static uint32_t index_of(const uint8_t symbol) noexcept
         {
-            static constinit const uint32_t ii = invalid_index();
-            static constinit const uint32_t indexes[] = {
+            static constinit const uint8_t ii = invalid_index();
+            static constinit const uint8_t indexes[] = {
                  ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, //   0-15
                  ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, //  16-31
                  ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, ii, 62, ii, ii, //  32-47
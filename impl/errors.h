@@ -1,47 +1,56 @@
 #pragma once
 
-#include "encoding_traits.h"
+#include "result.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <string>
-#include <string_view>
 
 
 namespace base64
 {
     ////////////////////////////////////////////////////////////////////////////////////////////////
-    // error_type_t enum definition
+    // error_code_t class declaration
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
-    enum class error_type_t
-    {
-        no_error = 0,
-        insufficient_buffer_size,
-        invalid_buffer_size,
-        non_alphabetic_symbol
-    };
-
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    // error_code_t class definition
-    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // The error keeps only its parameters (no allocations on the error path), the message is
+    // formatted on request. The class is trivially copyable.
 
     class error_code_t
     {
     public:
         error_code_t() noexcept = default;
-        error_code_t(error_type_t code, std::string msg) noexcept : m_msg(std::move(msg)), m_code(code) {}
-        ~error_code_t() noexcept = default;
-
-        error_type_t type() const noexcept          {   return m_code;  }
-        const std::string & msg() const noexcept    {   return m_msg;   }
+        error_code_t(
+            error_type_t    code,
+            size_t          pos,
+            uint8_t         symbol,
+            size_t          required_size,
+            size_t          obtained_size,
+            bool            padded) noexcept;
+
+        error_type_t type() const noexcept          {   return m_code;              }
+        std::string msg() const;
+
+        // index (and value) of the non-alphabetic symbol, the misplaced pad or the last symbol
+        // with non-zero trailing bits
+        size_t pos() const noexcept                 {   return m_pos;               }
+        uint8_t symbol() const noexcept             {   return m_symbol;            }
+
+        // insufficient (or invalid) buffer size: the required and the obtained sizes
+        size_t required_size() const noexcept       {   return m_required_size;     }
+        size_t obtained_size() const noexcept       {   return m_obtained_size;     }
 
         bool has_error() const noexcept             {   return m_code != error_type_t::no_error;    }
         explicit operator bool() const noexcept     {   return has_error();                         }
 
     private:
-        std::string     m_msg;
+        size_t          m_pos = 0;
+        size_t          m_required_size = 0;
+        size_t          m_obtained_size = 0;
         error_type_t    m_code = error_type_t::no_error;
+        uint8_t         m_symbol = 0;
+        bool            m_padded = false;   // the encoding uses padding
     };
 
 
@@ -51,96 +60,131 @@ namespace detail
     // helper functions declaration
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
-    error_code_t insufficient_buffer_size_error(size_t obtained_size, size_t required_size);
+    error_code_t insufficient_buffer_size_error(size_t obtained_size, size_t required_size) noexcept;
 
     template <typename encoding_traits>
-    error_code_t invalid_buffer_size_error(size_t base64_buffer_size);
+    error_code_t invalid_buffer_size_error(size_t base64_buffer_size) noexcept;
 
-    error_code_t non_alphabetic_symbol_error(size_t pos, uint8_t bad_symbol);
-
-    template <typename encoding_traits>
-    bool check_base64_buffer_size(size_t base64_buffer_size);
+    error_code_t non_alphabetic_symbol_error(size_t pos, uint8_t bad_symbol) noexcept;
+    error_code_t misplaced_pad_error(size_t pos, uint8_t pad) noexcept;
+    error_code_t non_canonical_trailing_bits_error(size_t pos, uint8_t last_symbol) noexcept;
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // helper functions definition
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
-    // Note: a formatting library is not used here (a good one like 'fmt').
-    //       fmt is good, but external dependency is bad.
-
     ////////////////////////////////////////////////////////////////////////////////////////////////
-    inline error_code_t insufficient_buffer_size_error(size_t obtained_size, size_t required_size)
+    inline error_code_t insufficient_buffer_size_error(size_t obtained_size, size_t required_size) noexcept
     {
-        constexpr size_t msg_buffer_size = 255;
-        std::string msg(msg_buffer_size + 1, '\0');
-
-        constexpr std::string_view msg_template =
-            "The buffer has insufficient size (required - %zu, obtained - %zu).";
-
-        std::snprintf(msg.data(), msg_buffer_size, msg_template.data(), required_size, obtained_size);
-
-        return error_code_t(error_type_t::insufficient_buffer_size, msg.c_str());
+        return error_code_t(error_type_t::insufficient_buffer_size, 0, 0, required_size, obtained_size, false);
     }
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     template <typename encoding_traits>
-    inline error_code_t invalid_buffer_size_error(size_t base64_buffer_size)
+    inline error_code_t invalid_buffer_size_error(size_t base64_buffer_size) noexcept
     {
-        constexpr size_t msg_buffer_size = 255;
-        std::string msg(msg_buffer_size + 1, '\0');
+        return error_code_t(
+            error_type_t::invalid_buffer_size, 0, 0, 0, base64_buffer_size, encoding_traits::has_pad());
+    }
 
-        if constexpr (encoding_traits::has_pad())
-        {
-            constexpr std::string_view msg_template =
-                "The base64 buffer has invalid size of %zu. "
-                "The buffer size must be a multiple of 4.";
 
-            std::snprintf(msg.data(), msg_buffer_size, msg_template.data(), base64_buffer_size);
-        }
-        else
-        {
-            constexpr std::string_view msg_template =
-                "The base64 buffer has invalid size of %zu. "
-                "The buffer size must be a multiple of 4 or have a remainder of division 2 and 3.";
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline error_code_t non_alphabetic_symbol_error(size_t pos, uint8_t bad_symbol) noexcept
+    {
+        return error_code_t(error_type_t::non_alphabetic_symbol, pos, bad_symbol, 0, 0, false);
+    }
 
-            std::snprintf(msg.data(), msg_buffer_size, msg_template.data(), base64_buffer_size);
-        }
 
-        return error_code_t(error_type_t::invalid_buffer_size, msg.c_str());
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline error_code_t misplaced_pad_error(size_t pos, uint8_t pad) noexcept
+    {
+        return error_code_t(error_type_t::misplaced_pad, pos, pad, 0, 0, true);
     }
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
-    inline error_code_t non_alphabetic_symbol_error(size_t pos, uint8_t bad_symbol)
+    inline error_code_t non_canonical_trailing_bits_error(size_t pos, uint8_t last_symbol) noexcept
     {
-        constexpr size_t msg_buffer_size = 255;
-        std::string msg(msg_buffer_size + 1, '\0');
+        return error_code_t(error_type_t::non_canonical_trailing_bits, pos, last_symbol, 0, 0, false);
+    }
 
-        constexpr std::string_view msg_template =
-            "The buffer has the non-alphabetical character 0x%02X at index %zu.";
+}   // namespace detail
 
-        std::snprintf(msg.data(), msg_buffer_size, msg_template.data(), bad_symbol, pos);
 
-        return error_code_t(error_type_t::non_alphabetic_symbol, msg.c_str());
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // error_code_t class definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline error_code_t::error_code_t(
+        error_type_t    code,
+        size_t          pos,
+        uint8_t         symbol,
+        size_t          required_size,
+        size_t          obtained_size,
+        bool            padded) noexcept
+        : m_pos(pos)
+        , m_required_size(required_size)
+        , m_obtained_size(obtained_size)
+        , m_code(code)
+        , m_symbol(symbol)
+        , m_padded(padded)
+    {
     }
 
 
+    // Note: a formatting library is not used here (a good one like 'fmt').
+    //       fmt is good, but external dependency is bad.
+
     ////////////////////////////////////////////////////////////////////////////////////////////////
-    template <typename encoding_traits>
-    inline bool check_base64_buffer_size(size_t base64_buffer_size)
+    inline std::string error_code_t::msg() const
     {
-        if constexpr (encoding_traits::has_pad())
-        {
-            return base64_buffer_size % 4 == 0;
-        }
-        else
+        constexpr size_t msg_buffer_size = 256;
+        char msg[msg_buffer_size] = {};
+
+        switch (m_code)
         {
-            const size_t tail_size = base64_buffer_size % 4;
-            return tail_size == 0 || tail_size == 2 || tail_size == 3;
+        case error_type_t::no_error:
+            break;
+
+        case error_type_t::insufficient_buffer_size:
+            std::snprintf(msg, msg_buffer_size,
+                "The buffer has insufficient size (required - %zu, obtained - %zu).",
+                m_required_size, m_obtained_size);
+            break;
+
+        case error_type_t::invalid_buffer_size:
+            std::snprintf(msg, msg_buffer_size,
+                m_padded ?
+                    "The base64 buffer has invalid size of %zu. "
+                    "The buffer size must be a multiple of 4." :
+                    "The base64 buffer has invalid size of %zu. "
+                    "The buffer size must be a multiple of 4 or have a remainder of division 2 and 3.",
+                m_obtained_size);
+            break;
+
+        case error_type_t::non_alphabetic_symbol:
+            std::snprintf(msg, msg_buffer_size,
+                "The buffer has the non-alphabetical character 0x%02X at index %zu.",
+                static_cast<unsigned>(m_symbol), m_pos);
+            break;
+
+        case error_type_t::misplaced_pad:
+            std::snprintf(msg, msg_buffer_size,
+                "The buffer has the misplaced pad character 0x%02X at index %zu.",
+                static_cast<unsigned>(m_symbol), m_pos);
+            break;
+
+        case error_type_t::non_canonical_trailing_bits:
+            std::snprintf(msg, msg_buffer_size,
+                "The buffer has non-zero trailing bits in the character 0x%02X at index %zu.",
+                static_cast<unsigned>(m_symbol), m_pos);
+            break;
         }
+
+        return std::string(msg);
     }
 
-}   // namespace detail
 }   // namespace base64
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "adapters.h"
+#include "buffer.h"
 
 #include <array>
 #include <string>
@@ -30,6 +31,10 @@ namespace base64
     const_adapter_t make_const_adapter(const const_adapter_t & adapter) noexcept;
     const_adapter_t make_const_adapter(const mutable_adapter_t & adapter) noexcept;
 
+    // buffer_t adapter makers
+    mutable_adapter_t make_mutable_adapter(buffer_t & data) noexcept;
+    const_adapter_t make_const_adapter(const buffer_t & data) noexcept;
+
     // std::array<> adapter makers
     template <typename pod_type, size_t array_size>
     mutable_adapter_t make_mutable_adapter(std::array<pod_type, array_size> & data) noexcept;
@@ -95,6 +100,18 @@ namespace base64
         return const_adapter_t(adapter.data(), adapter.size());
     }
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline mutable_adapter_t make_mutable_adapter(buffer_t & data) noexcept
+    {
+        return mutable_adapter_t(data.data(), data.size());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline const_adapter_t make_const_adapter(const buffer_t & data) noexcept
+    {
+        return const_adapter_t(data.data(), data.size());
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////
     template <typename pod_type, size_t array_size>
     inline mutable_adapter_t make_mutable_adapter(std::array<pod_type, array_size> & data) noexcept
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace base64
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // error_type_t enum definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    enum class error_type_t
+    {
+        no_error = 0,
+        insufficient_buffer_size,
+        invalid_buffer_size,
+        non_alphabetic_symbol,
+        misplaced_pad,                  // strict decoding only
+        non_canonical_trailing_bits     // strict decoding only
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // raw_result_t struct definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Result of the low-level functions (see base64_raw.h).
+    //  - no error: the whole input is consumed, written is the exact size of the output
+    //  - non_alphabetic_symbol, misplaced_pad and non_canonical_trailing_bits: consumed is the
+    //    index of the bad symbol, written is the number of bytes decoded before the quad containing it
+    //  - buffer size errors: nothing is consumed or written
+
+    struct raw_result_t
+    {
+        error_type_t    status = error_type_t::no_error;
+        size_t          consumed = 0;
+        size_t          written = 0;
+    };
+
+}   // namespace base64
@@ -0,0 +1,430 @@
+#pragma once
+
+#include "tables.h"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace base64
+{
+namespace detail
+{
+namespace scalar
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // scalar kernels declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    uint32_t byteswap_32(uint32_t value) noexcept;
+    uint64_t byteswap_64(uint64_t value) noexcept;
+    uint32_t load_be32(const uint8_t * src) noexcept;
+    uint64_t load_be64(const uint8_t * src) noexcept;
+    void store_be32(uint8_t * dst, uint32_t value) noexcept;
+    void store_be64(uint8_t * dst, uint64_t value) noexcept;
+
+    // SWAR encoder: encodes the longest prefix of complete 6-byte groups which can be processed
+    // with 8-byte loads without reading beyond src_size. Every group is split into four 12-bit
+    // values which are looked up in the pair table. Returns the number of consumed bytes.
+    template <typename encoding_traits>
+    size_t encode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    // Unrolled encoder: every step encodes 4 independent triples (12 bytes) loaded with 32-bit
+    // loads and writes 16 symbols with two 8-byte stores. Returns the number of consumed bytes.
+    template <typename encoding_traits>
+    size_t encode_x4(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    // Encodes triple_count complete triples without any bounds checks.
+    template <typename encoding_traits>
+    void encode_triples(const uint8_t * src, size_t triple_count, uint8_t * dst) noexcept;
+
+    // Encodes the last 1 or 2 bytes: writes 2 or 3 symbols followed by the padding (if any).
+    // Returns the number of written characters.
+    template <typename encoding_traits>
+    size_t encode_tail(const uint8_t * src, size_t tail_size, uint8_t * dst) noexcept;
+
+    // Table-driven decoder: every quad is decoded with four lookups in the pre-shifted tables
+    // and no branches, the bad symbol flag is checked once per block of 8 quads. Returns the
+    // number of consumed symbols; the block containing a bad symbol (or a pad) is left to the
+    // caller and nothing is written for it.
+    template <typename encoding_traits>
+    size_t decode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    // Unrolled decoder: every step decodes 4 independent quads (16 symbols) and writes 12 bytes
+    // with an 8-byte and a 4-byte store. Returns the number of consumed symbols; the step
+    // containing a bad symbol (or a pad) is left to the caller and nothing is written for it.
+    template <typename encoding_traits>
+    size_t decode_x4(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    // Checks the longest prefix of complete 32-symbol blocks that contain only alphabetic symbols
+    // (one flag check per block) with the byte-sized index_of() table, so validation touches
+    // 4 cache lines instead of the 16 of a decoding table. Returns its size.
+    template <typename encoding_traits>
+    size_t validate(const uint8_t * src, size_t src_size) noexcept;
+
+    // Returns the index of the first symbol which is neither alphabetic nor a pad (src_size if
+    // there is no such symbol).
+    template <typename encoding_traits>
+    size_t locate_invalid(const uint8_t * src, size_t src_size) noexcept;
+
+    // Stores the indexes of the symbols which are neither alphabetic nor a pad in [pos, src_size)
+    // to positions[count, max_count) and advances count.
+    template <typename encoding_traits>
+    void collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          pos,
+        size_t          * positions,
+        size_t          max_count,
+        size_t          & count) noexcept;
+
+    // Decodes up to quad_count complete quads writing 3 bytes per quad without any bounds checks.
+    // Stops at the first quad containing a bad symbol (or a pad) and returns the number of
+    // consumed symbols; nothing is written for that quad.
+    template <typename encoding_traits>
+    size_t decode_quads(const uint8_t * src, size_t quad_count, uint8_t * dst) noexcept;
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // scalar kernels definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline uint32_t byteswap_32(uint32_t value) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _byteswap_ulong(value);
+#else
+        return __builtin_bswap32(value);
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline uint64_t byteswap_64(uint64_t value) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _byteswap_uint64(value);
+#else
+        return __builtin_bswap64(value);
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline uint32_t load_be32(const uint8_t * src) noexcept
+    {
+        uint32_t value;
+        std::memcpy(&value, src, sizeof(value));
+
+        if constexpr (std::endian::native == std::endian::little)
+            value = byteswap_32(value);
+
+        return value;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline uint64_t load_be64(const uint8_t * src) noexcept
+    {
+        uint64_t value;
+        std::memcpy(&value, src, sizeof(value));
+
+        if constexpr (std::endian::native == std::endian::little)
+            value = byteswap_64(value);
+
+        return value;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline void store_be32(uint8_t * dst, uint32_t value) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little)
+            value = byteswap_32(value);
+
+        std::memcpy(dst, &value, sizeof(value));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    inline void store_be64(uint8_t * dst, uint64_t value) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little)
+            value = byteswap_64(value);
+
+        std::memcpy(dst, &value, sizeof(value));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t encode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        const auto & pairs = tables_t<encoding_traits>::pairs;
+
+        size_t i = 0;
+        for (; i + 8 <= src_size; i += 6, dst += 8)
+        {
+            // 6 bytes (8 sextets) in the high 48 bits
+            const uint64_t bits = load_be64(src + i);
+
+            const uint64_t pair_a = pairs[(bits >> 52) & 0xFFF];
+            const uint64_t pair_b = pairs[(bits >> 40) & 0xFFF];
+            const uint64_t pair_c = pairs[(bits >> 28) & 0xFFF];
+            const uint64_t pair_d = pairs[(bits >> 16) & 0xFFF];
+
+            // one 8-byte store instead of eight byte stores
+            const uint64_t symbols = (pair_a << 48) | (pair_b << 32) | (pair_c << 16) | pair_d;
+            store_be64(dst, symbols);
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t encode_x4(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        const auto & pairs = tables_t<encoding_traits>::pairs;
+
+        // a step reads 13 bytes (the last 32-bit load overlaps the next step) and consumes 12
+        size_t i = 0;
+        for (; i + 13 <= src_size; i += 12, dst += 16)
+        {
+            // every triple in the high 24 bits
+            const uint32_t triple_0 = load_be32(src + i + 0);
+            const uint32_t triple_1 = load_be32(src + i + 3);
+            const uint32_t triple_2 = load_be32(src + i + 6);
+            const uint32_t triple_3 = load_be32(src + i + 9);
+
+            // 4 symbols of every triple
+            const uint32_t symbols_0 = (uint32_t{ pairs[triple_0 >> 20] } << 16) | pairs[(triple_0 >> 8) & 0xFFF];
+            const uint32_t symbols_1 = (uint32_t{ pairs[triple_1 >> 20] } << 16) | pairs[(triple_1 >> 8) & 0xFFF];
+            const uint32_t symbols_2 = (uint32_t{ pairs[triple_2 >> 20] } << 16) | pairs[(triple_2 >> 8) & 0xFFF];
+            const uint32_t symbols_3 = (uint32_t{ pairs[triple_3 >> 20] } << 16) | pairs[(triple_3 >> 8) & 0xFFF];
+
+            const uint64_t symbols_01 = (uint64_t{ symbols_0 } << 32) | symbols_1;
+            const uint64_t symbols_23 = (uint64_t{ symbols_2 } << 32) | symbols_3;
+
+            store_be64(dst, symbols_01);
+            store_be64(dst + 8, symbols_23);
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline void encode_triples(const uint8_t * src, size_t triple_count, uint8_t * dst) noexcept
+    {
+        const auto & pairs = tables_t<encoding_traits>::pairs;
+
+        for (size_t k = 0; k < triple_count; ++k, src += 3, dst += 4)
+        {
+            const uint32_t triple = (uint32_t{ src[0] } << 16) | (uint32_t{ src[1] } << 8) | src[2];
+
+            const uint16_t pair_ab = pairs[triple >> 12];
+            const uint16_t pair_cd = pairs[triple & 0xFFF];
+
+            dst[0] = static_cast<uint8_t>(pair_ab >> 8);
+            dst[1] = static_cast<uint8_t>(pair_ab);
+            dst[2] = static_cast<uint8_t>(pair_cd >> 8);
+            dst[3] = static_cast<uint8_t>(pair_cd);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t encode_tail(const uint8_t * src, size_t tail_size, uint8_t * dst) noexcept
+    {
+        assert(tail_size == 1 || tail_size == 2);
+
+        const auto & pairs = tables_t<encoding_traits>::pairs;
+
+        const uint32_t octet_b = tail_size == 2 ? src[1] : 0;
+        const uint32_t triple = (uint32_t{ src[0] } << 16) | (octet_b << 8);
+
+        const uint16_t pair_ab = pairs[triple >> 12];
+        dst[0] = static_cast<uint8_t>(pair_ab >> 8);
+        dst[1] = static_cast<uint8_t>(pair_ab);
+
+        size_t size = 2;
+        if (tail_size == 2)
+            dst[size++] = static_cast<uint8_t>(pairs[triple & 0xFFF] >> 8);
+
+        if constexpr (encoding_traits::has_pad())
+        {
+            while (size < 4)
+                dst[size++] = encoding_traits::pad();
+        }
+
+        return size;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t decode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        using tables = tables_t<encoding_traits>;
+
+        const auto & d0 = tables::shifted[0];
+        const auto & d1 = tables::shifted[1];
+        const auto & d2 = tables::shifted[2];
+        const auto & d3 = tables::shifted[3];
+
+        constexpr size_t block_size = 32;
+
+        size_t i = 0;
+        for (; i + block_size <= src_size; i += block_size, dst += 3 * block_size / 4)
+        {
+            const uint8_t * quad = src + i;
+            uint64_t t[block_size / 4];
+
+            for (size_t k = 0; k < block_size / 4; ++k, quad += 4)
+                t[k] = d0[quad[0]] | d1[quad[1]] | d2[quad[2]] | d3[quad[3]];
+
+            if (((t[0] | t[1] | t[2] | t[3] | t[4] | t[5] | t[6] | t[7]) & tables::bad_symbol) != 0)
+                break;
+
+            // 24 bytes with three 8-byte stores
+            store_be64(dst, (t[0] << 40) | (t[1] << 16) | (t[2] >> 8));
+            store_be64(dst + 8, (t[2] << 56) | (t[3] << 32) | (t[4] << 8) | (t[5] >> 16));
+            store_be64(dst + 16, (t[5] << 48) | (t[6] << 24) | t[7]);
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t decode_x4(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        using tables = tables_t<encoding_traits>;
+
+        const auto & d0 = tables::shifted[0];
+        const auto & d1 = tables::shifted[1];
+        const auto & d2 = tables::shifted[2];
+        const auto & d3 = tables::shifted[3];
+
+        size_t i = 0;
+        for (; i + 16 <= src_size; i += 16, dst += 12)
+        {
+            const uint8_t * quad = src + i;
+
+            const uint32_t triple_0 = d0[quad[0]] | d1[quad[1]] | d2[quad[2]] | d3[quad[3]];
+            const uint32_t triple_1 = d0[quad[4]] | d1[quad[5]] | d2[quad[6]] | d3[quad[7]];
+            const uint32_t triple_2 = d0[quad[8]] | d1[quad[9]] | d2[quad[10]] | d3[quad[11]];
+            const uint32_t triple_3 = d0[quad[12]] | d1[quad[13]] | d2[quad[14]] | d3[quad[15]];
+
+            if (((triple_0 | triple_1 | triple_2 | triple_3) & tables::bad_symbol) != 0)
+                break;
+
+            // 12 bytes: triples 0, 1 and the high 2 bytes of triple 2, then the rest
+            store_be64(dst, (uint64_t{ triple_0 } << 40) | (uint64_t{ triple_1 } << 16) | (triple_2 >> 8));
+            store_be32(dst + 8, (triple_2 << 24) | triple_3);
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t validate(const uint8_t * src, size_t src_size) noexcept
+    {
+        // the indexes are below 64 and invalid_index() is 64, so OR-ing them accumulates the flag
+        static_assert(encoding_traits::invalid_index() == 64);
+
+        constexpr size_t block_size = 32;
+
+        size_t i = 0;
+        for (; i + block_size <= src_size; i += block_size)
+        {
+            // two independent chains and 4 symbols per step, a single chain runs about a third
+            // slower with byte-sized lookups
+            uint32_t flags_0 = 0;
+            uint32_t flags_1 = 0;
+
+            for (size_t k = 0; k < block_size; k += 4)
+            {
+                flags_0 |= encoding_traits::index_of(src[i + k])
+                    | encoding_traits::index_of(src[i + k + 2]);
+                flags_1 |= encoding_traits::index_of(src[i + k + 1])
+                    | encoding_traits::index_of(src[i + k + 3]);
+            }
+
+            if (((flags_0 | flags_1) & encoding_traits::invalid_index()) != 0)
+                break;
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t locate_invalid(const uint8_t * src, size_t src_size) noexcept
+    {
+        for (size_t i = 0; i < src_size; ++i)
+        {
+            if constexpr (encoding_traits::has_pad())
+            {
+                if (src[i] == encoding_traits::pad())
+                    continue;
+            }
+
+            if (encoding_traits::index_of(src[i]) == encoding_traits::invalid_index())
+                return i;
+        }
+
+        return src_size;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline void collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          pos,
+        size_t          * positions,
+        size_t          max_count,
+        size_t          & count) noexcept
+    {
+        for (; count < max_count; ++pos)
+        {
+            pos += locate_invalid<encoding_traits>(src + pos, src_size - pos);
+
+            if (pos == src_size)
+                break;
+
+            positions[count++] = pos;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t decode_quads(const uint8_t * src, size_t quad_count, uint8_t * dst) noexcept
+    {
+        using tables = tables_t<encoding_traits>;
+
+        const auto & d0 = tables::shifted[0];
+        const auto & d1 = tables::shifted[1];
+        const auto & d2 = tables::shifted[2];
+        const auto & d3 = tables::shifted[3];
+
+        size_t k = 0;
+        for (; k < quad_count; ++k, src += 4, dst += 3)
+        {
+            const uint32_t triple = d0[src[0]] | d1[src[1]] | d2[src[2]] | d3[src[3]];
+
+            if ((triple & tables::bad_symbol) != 0)
+                break;
+
+            dst[0] = static_cast<uint8_t>(triple >> 16);
+            dst[1] = static_cast<uint8_t>(triple >> 8);
+            dst[2] = static_cast<uint8_t>(triple);
+        }
+
+        return 4 * k;
+    }
+
+}   // namespace scalar
+}   // namespace detail
+}   // namespace base64
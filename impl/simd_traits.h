@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+
+namespace base64
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // simd_traits_t struct definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Vector kernels map sextets to symbols (and back) with range arithmetic, so they require
+    // the "A-Za-z0-9" layout of the first 62 symbols. The last two symbols are arbitrary.
+
+    template <typename encoding_traits>
+    struct simd_traits_t
+    {
+        static constexpr std::string_view std_symbols() noexcept
+        {
+            return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+        }
+
+        static constexpr uint8_t char_62() noexcept     {   return encoding_traits::char_at(62);    }
+        static constexpr uint8_t char_63() noexcept     {   return encoding_traits::char_at(63);    }
+
+        static constexpr bool supported() noexcept
+        {
+            if (encoding_traits::alphabet().substr(0, 62) != std_symbols())
+                return false;
+
+            for (const char symbol : std_symbols())
+            {
+                if (static_cast<uint8_t>(symbol) == char_62() || static_cast<uint8_t>(symbol) == char_63())
+                    return false;
+            }
+
+            return char_62() != char_63();
+        }
+    };
+
+}   // namespace detail
+}   // namespace base64
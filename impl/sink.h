@@ -0,0 +1,171 @@
+#pragma once
+
+#include "adapters.h"
+#include "codec.h"
+#include "decode.h"
+#include "encode.h"
+#include "errors.h"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+
+namespace base64
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // sink functions declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // A sink receives the output in blocks: a callable void(const byte_type * data, size_t size)
+    // or an output iterator of byte_type. The sink is used in place, so an output iterator passed
+    // as an lvalue is left past the written output, a temporary one is advanced only internally.
+    template <typename sink_type, typename byte_type>
+    concept sink_of = std::invocable<std::remove_cvref_t<sink_type> &, const byte_type *, size_t>
+        || std::output_iterator<std::remove_cvref_t<sink_type>, byte_type>;
+
+    // The output is staged in a block on the stack (staging_block_size bytes) and flushed to
+    // the sink as the block fills up, so no buffer for the whole output is allocated.
+    inline constexpr size_t staging_block_size = 4096;
+
+    template <typename encoding_traits, typename sink_type>
+    void encode_to_sink_impl(
+        const const_adapter_t       & raw_data,
+        sink_type                   & sink);
+
+    // On error the sink has received the data decoded before the invalid symbol.
+    template <typename encoding_traits, typename sink_type>
+    error_code_t decode_to_sink_impl(
+        const const_adapter_t       & base64_data,
+        sink_type                   & sink);
+
+
+namespace detail
+{
+    template <typename byte_type, typename sink_type>
+    void flush_to_sink(sink_type & sink, const uint8_t * data, size_t size);
+
+}   // namespace detail
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // sink functions definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits, typename sink_type>
+    inline void encode_to_sink_impl(
+        const const_adapter_t       & raw_data,
+        sink_type                   & sink)
+    {
+        // complete triples in every block except the last one, so no padding inside
+        constexpr size_t raw_block_size = 3 * (staging_block_size / 4);
+        uint8_t block[staging_block_size];
+
+        for (size_t pos = 0; pos < raw_data.size(); pos += raw_block_size)
+        {
+            const size_t size = std::min(raw_block_size, raw_data.size() - pos);
+            const raw_result_t result = encode_raw_impl<encoding_traits>(
+                raw_data.data() + pos, size, block, sizeof(block));
+
+            detail::flush_to_sink<char>(sink, block, result.written);
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits, typename sink_type>
+    inline error_code_t decode_to_sink_impl(
+        const const_adapter_t       & base64_data,
+        sink_type                   & sink)
+    {
+        if (!detail::check_base64_buffer_size<encoding_traits>(base64_data.size()))
+            return detail::invalid_buffer_size_error<encoding_traits>(base64_data.size());
+
+        constexpr size_t raw_block_size = 3 * (staging_block_size / 4);
+        uint8_t block[raw_block_size];
+
+        const uint8_t * const base64_ptr = base64_data.data();
+        const size_t base64_size = base64_data.size();
+
+        for (size_t pos = 0; pos < base64_size; pos += staging_block_size)
+        {
+            const bool last = base64_size - pos <= staging_block_size;
+            const size_t size = last ? base64_size - pos : staging_block_size;
+
+            // The last quad of every call is decoded as the last quad of the data, so the quads
+            // with a pad (decoded as zero bits in the middle of the data) at the end of
+            // an intermediate block are decoded one by one with the pads replaced.
+            size_t body_size = size;
+
+            if constexpr (encoding_traits::has_pad())
+            {
+                while (!last && body_size > 0)
+                {
+                    const uint8_t * const quad_end = base64_ptr + pos + body_size;
+
+                    if (std::find(quad_end - 4, quad_end, encoding_traits::pad()) == quad_end)
+                        break;
+
+                    body_size -= 4;
+                }
+            }
+
+            raw_result_t result = decode_raw_impl<encoding_traits>(
+                base64_ptr + pos, body_size, block, sizeof(block));
+
+            size_t written = result.written;
+
+            if constexpr (encoding_traits::has_pad())
+            {
+                for (size_t quad_pos = body_size;
+                    quad_pos < size && result.status == error_type_t::no_error; quad_pos += 4)
+                {
+                    uint8_t quad[4];
+                    std::replace_copy(base64_ptr + pos + quad_pos, base64_ptr + pos + quad_pos + 4,
+                        quad, encoding_traits::pad(), encoding_traits::char_at(0));
+
+                    result = decode_raw_impl<encoding_traits>(
+                        quad, sizeof(quad), block + written, 3);
+                    result.consumed += quad_pos;
+                    written += result.written;
+                }
+            }
+
+            detail::flush_to_sink<uint8_t>(sink, block, written);
+
+            if (result.status != error_type_t::no_error)
+            {
+                result.consumed += pos;
+                return detail::make_decode_error<encoding_traits>(result, base64_data, 0);
+            }
+        }
+
+        return error_code_t{};
+    }
+
+
+
+namespace detail
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename byte_type, typename sink_type>
+    inline void flush_to_sink(sink_type & sink, const uint8_t * data, size_t size)
+    {
+        if (size == 0)
+            return;
+
+        const byte_type * const bytes = reinterpret_cast<const byte_type *>(data);
+
+        if constexpr (std::invocable<sink_type &, const byte_type *, size_t>)
+            sink(bytes, size);
+        else
+            sink = std::copy(bytes, bytes + size, sink);
+    }
+
+}   // namespace detail
+}   // namespace base64
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "config.h"
+#include "simd_traits.h"
+
+#if BASE64_HAS_SSSE3
+
+#include <tmmintrin.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+namespace base64
+{
+namespace detail
+{
+namespace ssse3
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // SSSE3 kernels declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Encodes the longest prefix of complete 12-byte blocks which can be processed without reading
+    // beyond src_size. Returns the number of consumed bytes (always a multiple of 3).
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    size_t encode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    // Decodes the longest prefix of complete 16-symbol blocks that contain only alphabetic symbols.
+    // Returns the number of consumed symbols (always a multiple of 4); the block containing a bad
+    // symbol (or a pad) is left to the scalar code.
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    size_t decode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept;
+
+    // Checks the longest prefix of complete 16-symbol blocks that contain only alphabetic symbols.
+    // Returns its size; the block containing a bad symbol (or a pad) is left to the scalar code.
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    size_t validate(const uint8_t * src, size_t src_size) noexcept;
+
+    // Returns the index of the first symbol which is neither alphabetic nor a pad, or the size of
+    // the longest prefix of complete 16-symbol blocks if there is no such symbol in the prefix.
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    size_t locate_invalid(const uint8_t * src, size_t src_size) noexcept;
+
+    // Stores the indexes of the symbols which are neither alphabetic nor a pad in the complete
+    // 16-symbol blocks of [pos, src_size) to positions[count, max_count) and advances count.
+    // Returns the end of the scanned blocks; the scan stops at the block that fills positions.
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    size_t collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          pos,
+        size_t          * positions,
+        size_t          max_count,
+        size_t          & count) noexcept;
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // SSSE3 kernels definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    BASE64_TARGET_SSSE3
+    inline __m128i load_128(const uint8_t * src) noexcept
+    {
+        return _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(src)));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    BASE64_TARGET_SSSE3
+    inline void store_128(uint8_t * dst, __m128i value) noexcept
+    {
+        _mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(dst)), value);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    BASE64_TARGET_SSSE3
+    inline void store_96(uint8_t * dst, __m128i value) noexcept
+    {
+        _mm_storel_epi64(static_cast<__m128i *>(static_cast<void *>(dst)), value);
+
+        const int32_t high = _mm_cvtsi128_si32(_mm_srli_si128(value, 8));
+        std::memcpy(dst + 8, &high, sizeof(high));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // converts 16 sextets (one per byte) to symbols
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    inline __m128i sextets_to_symbols(__m128i sextets) noexcept
+    {
+        using simd_traits = simd_traits_t<encoding_traits>;
+
+        constexpr char shift_upper = 'A';
+        constexpr char shift_lower = 'a' - 26;
+        constexpr char shift_digit = '0' - 52;
+        constexpr char shift_62 = static_cast<char>(static_cast<uint8_t>(simd_traits::char_62() - 62));
+        constexpr char shift_63 = static_cast<char>(static_cast<uint8_t>(simd_traits::char_63() - 63));
+
+        // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m128i ranges = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+        const __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+        ranges = _mm_or_si128(ranges, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+
+        const __m128i shifts = _mm_setr_epi8(
+            shift_lower, shift_digit, shift_digit, shift_digit, shift_digit, shift_digit,
+            shift_digit, shift_digit, shift_digit, shift_digit, shift_digit, shift_62,
+            shift_63, shift_upper, 0, 0);
+
+        return _mm_add_epi8(_mm_shuffle_epi8(shifts, ranges), sextets);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    inline size_t encode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        // every 3 bytes are spread into 4 bytes: [b1, b0, b2, b1]
+        const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+        // a step reads 16 bytes and consumes 12 of them
+        size_t i = 0;
+        for (; i + 16 <= src_size; i += 12, dst += 16)
+        {
+            const __m128i words = _mm_shuffle_epi8(load_128(src + i), spread);
+
+            // extract sextets a & c into bytes 0 & 2 and sextets b & d into bytes 1 & 3
+            const __m128i ac = _mm_mulhi_epu16(
+                _mm_and_si128(words, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+            const __m128i bd = _mm_mullo_epi16(
+                _mm_and_si128(words, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+
+            store_128(dst, sextets_to_symbols<encoding_traits>(_mm_or_si128(ac, bd)));
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // converts 16 symbols to sextets, valid_mask gets 0xFF for every alphabetic symbol
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    inline __m128i symbols_to_sextets(__m128i symbols, __m128i & valid_mask) noexcept
+    {
+        using simd_traits = simd_traits_t<encoding_traits>;
+
+        constexpr char shift_upper = static_cast<char>(0 - 'A');
+        constexpr char shift_lower = static_cast<char>(26 - 'a');
+        constexpr char shift_digit = static_cast<char>(52 - '0');
+        constexpr char shift_62 = static_cast<char>(static_cast<uint8_t>(62 - simd_traits::char_62()));
+        constexpr char shift_63 = static_cast<char>(static_cast<uint8_t>(63 - simd_traits::char_63()));
+        constexpr char symbol_62 = static_cast<char>(simd_traits::char_62());
+        constexpr char symbol_63 = static_cast<char>(simd_traits::char_63());
+
+        // signed comparisons: symbols 0x80-0xFF are negative and fall out of all ranges
+        const __m128i is_upper = _mm_and_si128(
+            _mm_cmpgt_epi8(symbols, _mm_set1_epi8('A' - 1)),
+            _mm_cmplt_epi8(symbols, _mm_set1_epi8('Z' + 1)));
+        const __m128i is_lower = _mm_and_si128(
+            _mm_cmpgt_epi8(symbols, _mm_set1_epi8('a' - 1)),
+            _mm_cmplt_epi8(symbols, _mm_set1_epi8('z' + 1)));
+        const __m128i is_digit = _mm_and_si128(
+            _mm_cmpgt_epi8(symbols, _mm_set1_epi8('0' - 1)),
+            _mm_cmplt_epi8(symbols, _mm_set1_epi8('9' + 1)));
+        const __m128i is_62 = _mm_cmpeq_epi8(symbols, _mm_set1_epi8(symbol_62));
+        const __m128i is_63 = _mm_cmpeq_epi8(symbols, _mm_set1_epi8(symbol_63));
+
+        valid_mask = _mm_or_si128(
+            _mm_or_si128(_mm_or_si128(is_upper, is_lower), is_digit), _mm_or_si128(is_62, is_63));
+
+        const __m128i shifts = _mm_or_si128(
+            _mm_or_si128(
+                _mm_and_si128(is_upper, _mm_set1_epi8(shift_upper)),
+                _mm_and_si128(is_lower, _mm_set1_epi8(shift_lower))),
+            _mm_or_si128(
+                _mm_and_si128(is_digit, _mm_set1_epi8(shift_digit)),
+                _mm_or_si128(
+                    _mm_and_si128(is_62, _mm_set1_epi8(shift_62)),
+                    _mm_and_si128(is_63, _mm_set1_epi8(shift_63)))));
+
+        return _mm_add_epi8(symbols, shifts);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    inline size_t decode(const uint8_t * src, size_t src_size, uint8_t * dst) noexcept
+    {
+        // 3 bytes of every 32-bit word are packed into the first 12 bytes
+        const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+        size_t i = 0;
+        for (; i + 16 <= src_size; i += 16, dst += 12)
+        {
+            __m128i valid_mask;
+            const __m128i sextets = symbols_to_sextets<encoding_traits>(load_128(src + i), valid_mask);
+
+            if (_mm_movemask_epi8(valid_mask) != 0xFFFF)
+                break;
+
+            // [a, b, c, d] -> [a << 6 | b, c << 6 | d] -> [a << 18 | b << 12 | c << 6 | d]
+            const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+            const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+
+            store_96(dst, _mm_shuffle_epi8(words, pack));
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // 0xFF for every alphabetic symbol, the same checks as in symbols_to_sextets()
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    inline __m128i alphabetic_mask(__m128i symbols) noexcept
+    {
+        using simd_traits = simd_traits_t<encoding_traits>;
+
+        constexpr char symbol_62 = static_cast<char>(simd_traits::char_62());
+        constexpr char symbol_63 = static_cast<char>(simd_traits::char_63());
+
+        const __m128i is_upper = _mm_and_si128(
+            _mm_cmpgt_epi8(symbols, _mm_set1_epi8('A' - 1)),
+            _mm_cmplt_epi8(symbols, _mm_set1_epi8('Z' + 1)));
+        const __m128i is_lower = _mm_and_si128(
+            _mm_cmpgt_epi8(symbols, _mm_set1_epi8('a' - 1)),
+            _mm_cmplt_epi8(symbols, _mm_set1_epi8('z' + 1)));
+        const __m128i is_digit = _mm_and_si128(
+            _mm_cmpgt_epi8(symbols, _mm_set1_epi8('0' - 1)),
+            _mm_cmplt_epi8(symbols, _mm_set1_epi8('9' + 1)));
+        const __m128i is_62 = _mm_cmpeq_epi8(symbols, _mm_set1_epi8(symbol_62));
+        const __m128i is_63 = _mm_cmpeq_epi8(symbols, _mm_set1_epi8(symbol_63));
+
+        return _mm_or_si128(
+            _mm_or_si128(_mm_or_si128(is_upper, is_lower), is_digit), _mm_or_si128(is_62, is_63));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    inline size_t validate(const uint8_t * src, size_t src_size) noexcept
+    {
+        size_t i = 0;
+
+        // two blocks per step, a single check of the combined mask
+        for (; i + 32 <= src_size; i += 32)
+        {
+            const __m128i valid_mask = _mm_and_si128(
+                alphabetic_mask<encoding_traits>(load_128(src + i)),
+                alphabetic_mask<encoding_traits>(load_128(src + i + 16)));
+
+            if (_mm_movemask_epi8(valid_mask) != 0xFFFF)
+                break;
+        }
+
+        for (; i + 16 <= src_size; i += 16)
+        {
+            if (_mm_movemask_epi8(alphabetic_mask<encoding_traits>(load_128(src + i))) != 0xFFFF)
+                break;
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    inline size_t locate_invalid(const uint8_t * src, size_t src_size) noexcept
+    {
+        size_t i = 0;
+        for (; i + 16 <= src_size; i += 16)
+        {
+            const __m128i symbols = load_128(src + i);
+            __m128i valid_mask = alphabetic_mask<encoding_traits>(symbols);
+
+            if constexpr (encoding_traits::has_pad())
+            {
+                const char pad = static_cast<char>(encoding_traits::pad());
+                valid_mask = _mm_or_si128(valid_mask, _mm_cmpeq_epi8(symbols, _mm_set1_epi8(pad)));
+            }
+
+            const uint32_t invalid_bits = ~static_cast<uint32_t>(_mm_movemask_epi8(valid_mask)) & 0xFFFF;
+
+            if (invalid_bits != 0)
+                return i + static_cast<size_t>(std::countr_zero(invalid_bits));
+        }
+
+        return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    BASE64_TARGET_SSSE3
+    inline size_t collect_invalid(
+        const uint8_t   * src,
+        size_t          src_size,
+        size_t          pos,
+        size_t          * positions,
+        size_t          max_count,
+        size_t          & count) noexcept
+    {
+        for (; pos + 16 <= src_size && count < max_count; pos += 16)
+        {
+            const __m128i symbols = load_128(src + pos);
+            __m128i valid_mask = alphabetic_mask<encoding_traits>(symbols);
+
+            if constexpr (encoding_traits::has_pad())
+            {
+                const char pad = static_cast<char>(encoding_traits::pad());
+                valid_mask = _mm_or_si128(valid_mask, _mm_cmpeq_epi8(symbols, _mm_set1_epi8(pad)));
+            }
+
+            uint32_t invalid_bits = ~static_cast<uint32_t>(_mm_movemask_epi8(valid_mask)) & 0xFFFF;
+
+            // one index per set bit, the lowest bit is cleared on every step
+            for (; invalid_bits != 0 && count < max_count; invalid_bits &= invalid_bits - 1)
+                positions[count++] = pos + static_cast<size_t>(std::countr_zero(invalid_bits));
+        }
+
+        return pos;
+    }
+
+}   // namespace ssse3
+}   // namespace detail
+}   // namespace base64
+
+#endif  // BASE64_HAS_SSSE3
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace base64
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // tables_t struct declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Lookup tables derived from the alphabet of an encoding at compile time.
+    template <typename encoding_traits>
+    struct tables_t
+    {
+        // symbol pairs for all 12-bit values (two sextets), the first symbol in the high byte
+        static constexpr std::array<uint16_t, 4096> make_pairs() noexcept;
+
+        // decoded sextets pre-shifted to their positions in a triple: shifted[k][symbol] is
+        // the k-th sextet of a quad, non-alphabetic symbols (and the pad) map to bad_symbol;
+        // used by the decoding only, the validation reads the byte-sized index_of() tables
+        static constexpr std::array<std::array<uint32_t, 256>, 4> make_shifted() noexcept;
+
+        static constexpr std::array<uint16_t, 4096> pairs = make_pairs();
+        static constexpr std::array<std::array<uint32_t, 256>, 4> shifted = make_shifted();
+
+        // above the 24 bits of a triple, so OR-ing the looked up values accumulates it
+        static constexpr uint32_t bad_symbol = 0x01000000;
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // tables_t struct definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    constexpr std::array<uint16_t, 4096> tables_t<encoding_traits>::make_pairs() noexcept
+    {
+        constexpr auto alphabet = encoding_traits::alphabet();
+        std::array<uint16_t, 4096> table{};
+
+        for (size_t i = 0; i < table.size(); ++i)
+        {
+            const auto first = static_cast<uint8_t>(alphabet[i >> 6]);
+            const auto second = static_cast<uint8_t>(alphabet[i & 0x3F]);
+            table[i] = static_cast<uint16_t>((first << 8) | second);
+        }
+
+        return table;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    constexpr std::array<std::array<uint32_t, 256>, 4> tables_t<encoding_traits>::make_shifted() noexcept
+    {
+        constexpr auto alphabet = encoding_traits::alphabet();
+        std::array<std::array<uint32_t, 256>, 4> tables{};
+
+        for (size_t k = 0; k < tables.size(); ++k)
+        {
+            tables[k].fill(bad_symbol);
+
+            for (size_t i = 0; i < alphabet.size(); ++i)
+                tables[k][static_cast<uint8_t>(alphabet[i])] = static_cast<uint32_t>(i << (18 - 6 * k));
+        }
+
+        return tables;
+    }
+
+}   // namespace detail
+}   // namespace base64
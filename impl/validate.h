@@ -0,0 +1,73 @@
+#pragma once
+
+#include "decode.h"
+#include "dispatch.h"
+#include "encoding_traits.h"
+#include "result.h"
+#include "scalar.h"
+
+
+namespace base64
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // validate functions declaration
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Checks the data with the same rules as decode_raw_impl() without writing any output:
+    // the size of the buffer and the symbols (a pad is accepted as in decoding).
+    // On the non_alphabetic_symbol error, consumed is the index of the bad symbol.
+    template <typename encoding_traits>
+    raw_result_t validate_raw_impl(const uint8_t * base64_ptr, size_t base64_size) noexcept;
+
+    // Stores the indexes of the non-alphabetic symbols (a pad is accepted as in decoding) in
+    // ascending order, at most max_count of them. Returns the number of stored indexes.
+    template <typename encoding_traits>
+    size_t find_invalid_symbols_impl(
+        const uint8_t   * base64_ptr,
+        size_t          base64_size,
+        size_t          * positions,
+        size_t          max_count) noexcept;
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // validate functions definition
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline raw_result_t validate_raw_impl(const uint8_t * base64_ptr, size_t base64_size) noexcept
+    {
+        if (!detail::check_base64_buffer_size<encoding_traits>(base64_size))
+        {
+            return raw_result_t{ error_type_t::invalid_buffer_size, 0, 0 };
+        }
+
+        size_t i = detail::validate_kernel<encoding_traits>(base64_ptr, base64_size);
+        i += detail::scalar::validate<encoding_traits>(base64_ptr + i, base64_size - i);
+
+        // the rest starts with a block containing a bad symbol (or a pad) or is shorter than a block
+        i += detail::locate_invalid<encoding_traits>(base64_ptr + i, base64_size - i);
+
+        if (i < base64_size)
+        {
+            return raw_result_t{ error_type_t::non_alphabetic_symbol, i, 0 };
+        }
+
+        return raw_result_t{ error_type_t::no_error, base64_size, 0 };
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename encoding_traits>
+    inline size_t find_invalid_symbols_impl(
+        const uint8_t   * base64_ptr,
+        size_t          base64_size,
+        size_t          * positions,
+        size_t          max_count) noexcept
+    {
+        return detail::collect_invalid<encoding_traits>(
+            base64_ptr, base64_size, positions, max_count);
+    }
+
+}   // namespace base64
@@ -1,8 +1,11 @@
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <memory>
 #include <ostream>
+#include <string>
 #include <string_view>
+#include <utility>
 
 #include "doctest/doctest.h"
 #include "base64.h"
@@ -100,3 +103,38 @@ TEST_CASE("define_adapter_makers")
     REQUIRE(!err_code);
     REQUIRE(text == std::string_view(decoded.Ptr(), decoded.Size()));
 }
+
+
+TEST_CASE("buffer_type")
+{
+    using namespace base64;
+
+    constexpr std::string_view data = "0123456789A";
+    constexpr std::string_view encoded = "MDEyMzQ1Njc4OUE=";
+
+    buffer_t decoded(calc_decoded_size(encoded), buffer_t::simd_alignment);
+    REQUIRE(decoded.size() == data.size());
+    REQUIRE(reinterpret_cast<uintptr_t>(decoded.data()) % buffer_t::simd_alignment == 0);
+    REQUIRE(!decode(encoded, decoded));
+    REQUIRE(std::string_view(reinterpret_cast<const char *>(decoded.data()), decoded.size()) == data);
+
+    // the buffer is a source for encoding as well
+    std::string reencoded(calc_encoded_size(decoded.size()), '\0');
+    REQUIRE(!encode(decoded, reencoded));
+    REQUIRE(reencoded == encoded);
+
+    buffer_t moved = std::move(decoded);
+    REQUIRE(decoded.size() == 0);
+    REQUIRE(decoded.data() == nullptr);
+    REQUIRE(moved.size() == data.size());
+
+    const uint8_t * const moved_data = moved.data();
+    const buffer_t::pointer_t released = moved.release();
+    REQUIRE(released.get() == moved_data);
+    REQUIRE(moved.size() == 0);
+    REQUIRE(moved.data() == nullptr);
+
+    buffer_t empty;
+    REQUIRE(!decode(std::string_view{}, empty));
+    REQUIRE(!encode(empty, reencoded));
+}
@@ -1,8 +1,13 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "doctest/doctest.h"
@@ -41,6 +46,8 @@ TEST_CASE("decode_errors")
     REQUIRE(error);
     REQUIRE(error.type() == error_type_t::insufficient_buffer_size);
     REQUIRE(error.msg() == "The buffer has insufficient size (required - 12, obtained - 0).");
+    REQUIRE(error.required_size() == 12);
+    REQUIRE(error.obtained_size() == 0);
     REQUIRE(decoded.empty());
 
     const size_t decoded_size = calc_decoded_size(data);
@@ -65,6 +72,86 @@ TEST_CASE("decode_errors")
     REQUIRE(error);
     REQUIRE(error.type() == error_type_t::non_alphabetic_symbol);
     REQUIRE(error.msg() == "The buffer has the non-alphabetical character 0x2A at index 10.");
+    REQUIRE(error.pos() == 10);
+    REQUIRE(error.symbol() == '*');
+
+    error = decode(data, decoded);
+    REQUIRE(!error);
+    REQUIRE(error.msg().empty());
+}
+
+
+TEST_CASE("decode_strict_errors")
+{
+    using namespace base64;
+    using namespace std::string_view_literals;
+
+    std::string decoded(12, '\0');
+
+    // the lenient decoding accepts non-canonical data
+    REQUIRE(!decode("MDEy=zQ1"sv, decoded));
+    REQUIRE(!decode("MDEyMZ=="sv, decoded));
+    REQUIRE(!decode("MDEyMzR="sv, decoded));
+
+    REQUIRE(!decode_strict("MDEyMzQ1"sv, decoded));
+    REQUIRE(!decode_strict("MDEyMw=="sv, decoded));
+    REQUIRE(!decode_strict("MDEyMzQ="sv, decoded));
+
+    error_code_t error = decode_strict("MDEy=zQ1"sv, decoded);
+    REQUIRE(error.type() == error_type_t::misplaced_pad);
+    REQUIRE(error.pos() == 4);
+    REQUIRE(error.msg() == "The buffer has the misplaced pad character 0x3D at index 4.");
+
+    error = decode_strict("MDEyM=Q1"sv, decoded);
+    REQUIRE(error.type() == error_type_t::misplaced_pad);
+    REQUIRE(error.pos() == 5);
+
+    error = decode_strict("MDEy=Q=="sv, decoded);
+    REQUIRE(error.type() == error_type_t::misplaced_pad);
+    REQUIRE(error.pos() == 4);
+
+    // the first error is reported: a pad before a non-alphabetic symbol and vice versa
+    error = decode_strict("MDEyMD=*"sv, decoded);
+    REQUIRE(error.type() == error_type_t::misplaced_pad);
+    REQUIRE(error.pos() == 6);
+
+    error = decode_strict("QUJD=A*AQUJD"sv, decoded);
+    REQUIRE(error.type() == error_type_t::misplaced_pad);
+    REQUIRE(error.pos() == 4);
+
+    error = decode_strict("QUJDQ*=AQUJD"sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_alphabetic_symbol);
+    REQUIRE(error.pos() == 5);
+
+    error = decode_strict("MDEy*=Q="sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_alphabetic_symbol);
+    REQUIRE(error.pos() == 4);
+
+    error = decode_strict("MDEyMD=1"sv, decoded);
+    REQUIRE(error.type() == error_type_t::misplaced_pad);
+    REQUIRE(error.pos() == 6);
+
+    error = decode_strict("MDEyMZ=="sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_canonical_trailing_bits);
+    REQUIRE(error.pos() == 5);
+    REQUIRE(error.msg() == "The buffer has non-zero trailing bits in the character 0x5A at index 5.");
+
+    error = decode_strict("MDEyMzR="sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_canonical_trailing_bits);
+    REQUIRE(error.pos() == 6);
+
+    error = decode_strict("MDEy*zR="sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_alphabetic_symbol);
+    REQUIRE(error.pos() == 4);
+}
+
+
+TEST_CASE("error_code_is_trivially_copyable")
+{
+    using namespace base64;
+
+    static_assert(std::is_trivially_copyable_v<error_code_t>);
+    static_assert(std::is_nothrow_default_constructible_v<error_code_t>);
 }
 
 
@@ -563,6 +650,132 @@ TEST_CASE("decode_binary_data")
 }
 
 
+TEST_CASE("encode_to_string")
+{
+    using namespace base64;
+
+    const std::vector<uint8_t> binary = make_bin_array(512);
+
+    for (const size_t size : { 0, 1, 2, 3, 100, 511, 512 })
+    {
+        const std::vector<uint8_t> data(binary.begin(), binary.begin() + size);
+
+        std::string expected(calc_encoded_size(size), '\0');
+        REQUIRE(!encode(data, expected));
+        REQUIRE(encode_to_string(data) == expected);
+    }
+}
+
+
+TEST_CASE("encode_append")
+{
+    using namespace base64;
+
+    constexpr std::string_view data_1 = "0";
+    constexpr std::string_view data_12 = "0123456789AB";
+
+    std::string header = "Authorization: Basic ";
+    encode_append(data_1, header);
+    REQUIRE(header == "Authorization: Basic MA==");
+
+    header += ", ";
+    encode_append(data_12, header);
+    encode_append(std::string_view{}, header);
+    REQUIRE(header == "Authorization: Basic MA==, MDEyMzQ1Njc4OUFC");
+
+    std::vector<char> document = { '[' };
+    encode_append(data_12, document);
+    encode_append(data_1, document);
+    REQUIRE(std::string_view(document.data(), document.size()) == "[MDEyMzQ1Njc4OUFCMA==");
+
+    byte_vector_t bytes;
+    encode_append(data_1, bytes);
+    REQUIRE(std::string_view(reinterpret_cast<const char *>(bytes.data()), bytes.size()) == "MA==");
+
+    // self-append: the source is reallocated by the growth of the container
+    const std::string heap_data(100, 'a');
+    std::string heap_encoded(calc_encoded_size(heap_data.size()), '\0');
+    REQUIRE(!encode(heap_data, heap_encoded));
+    const std::string expected = heap_data + heap_encoded;
+
+    std::string self = heap_data;
+    self.shrink_to_fit();
+    encode_append(self, self);
+    REQUIRE(self == expected);
+
+    std::vector<char> self_vector(heap_data.begin(), heap_data.end());
+    encode_append(std::string_view(self_vector.data() + 10, 50), self_vector);
+    std::string expected_part(calc_encoded_size(50), '\0');
+    REQUIRE(!encode(heap_data.substr(10, 50), expected_part));
+    REQUIRE(std::string_view(self_vector.data(), self_vector.size()) == heap_data + expected_part);
+}
+
+TEST_CASE("decode_to_vector")
+{
+    using namespace base64;
+    using namespace std::string_view_literals;
+
+    constexpr std::string_view encoded = "MDEyMzQ1Njc4OUE=";
+    const std::vector<uint8_t> expected = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A' };
+
+    std::vector<uint8_t> decoded(100, 0xFF);
+    REQUIRE(!decode_to_vector(encoded, decoded));
+    REQUIRE(decoded == expected);
+
+    byte_vector_t uninitialized_decoded;
+    REQUIRE(!decode_to_vector(encoded, uninitialized_decoded));
+    REQUIRE(std::equal(expected.begin(), expected.end(), uninitialized_decoded.begin(), uninitialized_decoded.end()));
+
+    REQUIRE(!decode_to_vector(std::string_view{}, decoded));
+    REQUIRE(decoded.empty());
+
+    // the data decoded before the error is kept
+    const error_code_t error = decode_to_vector("MDEyMzQ1N*c4OUE="sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_alphabetic_symbol);
+    REQUIRE(error.pos() == 9);
+    REQUIRE(decoded == std::vector<uint8_t>(expected.begin(), expected.begin() + 6));
+
+    REQUIRE(decode_to_vector(encoded.substr(1), decoded).type() == error_type_t::invalid_buffer_size);
+    REQUIRE(decoded.empty());
+
+    // short padded buffers of invalid size are reported without allocating
+    for (const std::string_view invalid : { "="sv, "=="sv, "A="sv, "AB="sv })
+    {
+        REQUIRE(calc_decoded_size(invalid) == 0);
+        REQUIRE(decode_to_vector(invalid, uninitialized_decoded).type() == error_type_t::invalid_buffer_size);
+        REQUIRE(uninitialized_decoded.empty());
+    }
+}
+
+TEST_CASE("pmr_allocating_functions")
+{
+    using namespace base64;
+
+    const std::vector<uint8_t> binary = make_bin_array(512);
+    std::string expected(calc_encoded_size(binary.size()), '\0');
+    REQUIRE(!encode(binary, expected));
+
+    // any allocation beyond the arena throws
+    alignas(std::max_align_t) std::array<uint8_t, 4096> arena_buffer;
+    std::pmr::monotonic_buffer_resource arena(
+        arena_buffer.data(), arena_buffer.size(), std::pmr::null_memory_resource());
+
+    const std::pmr::string encoded = encode_to_string(binary, &arena);
+    REQUIRE(std::string_view(encoded) == expected);
+    REQUIRE(encoded.get_allocator().resource() == &arena);
+
+    const std::pmr::string url_encoded = encode_url_to_string(binary, &arena);
+    REQUIRE(url_encoded.size() == calc_encoded_size_url(binary.size()));
+
+    pmr::byte_vector_t decoded(&arena);
+    REQUIRE(!decode_to_vector(encoded, decoded));
+    REQUIRE(std::equal(binary.begin(), binary.end(), decoded.begin(), decoded.end()));
+
+    std::pmr::vector<uint8_t> url_decoded(&arena);
+    REQUIRE(!decode_url_to_vector(url_encoded, url_decoded));
+    REQUIRE(url_decoded == std::pmr::vector<uint8_t>(binary.begin(), binary.end()));
+}
+
 TEST_CASE("encode_utf8")
 {
     using namespace base64;
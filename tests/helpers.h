@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <limits>
+#include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -14,3 +17,74 @@ inline std::vector<uint8_t> make_bin_array(size_t count)
 
     return data;
 };
+
+
+// pseudo-random bytes (deterministic, the same on all platforms)
+inline std::vector<uint8_t> make_random_array(size_t count, uint32_t seed = 1)
+{
+    std::vector<uint8_t> data(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = static_cast<uint8_t>(seed >> 16);
+    }
+
+    return data;
+}
+
+
+// straightforward bit-by-bit encoder used as a reference for the optimized kernels
+inline std::string reference_encode(std::string_view alphabet, char pad, const std::vector<uint8_t> & data)
+{
+    std::string encoded;
+    uint32_t bits = 0;
+    uint32_t bit_count = 0;
+
+    for (const uint8_t octet : data)
+    {
+        bits = (bits << 8) | octet;
+        bit_count += 8;
+
+        while (bit_count >= 6)
+        {
+            bit_count -= 6;
+            encoded.push_back(alphabet[(bits >> bit_count) & 0x3F]);
+        }
+    }
+
+    if (bit_count > 0)
+        encoded.push_back(alphabet[(bits << (6 - bit_count)) & 0x3F]);
+
+    while (pad != 0 && encoded.size() % 4 != 0)
+        encoded.push_back(pad);
+
+    return encoded;
+}
+
+
+// straightforward decoder used as a reference for the optimized kernels (expects valid input)
+inline std::vector<uint8_t> reference_decode(std::string_view alphabet, std::string_view encoded)
+{
+    std::vector<uint8_t> decoded;
+    uint32_t bits = 0;
+    uint32_t bit_count = 0;
+
+    for (const char symbol : encoded)
+    {
+        const size_t index = alphabet.find(symbol);
+        if (index == std::string_view::npos)
+            break;
+
+        bits = (bits << 6) | static_cast<uint32_t>(index);
+        bit_count += 6;
+
+        if (bit_count >= 8)
+        {
+            bit_count -= 8;
+            decoded.push_back(static_cast<uint8_t>(bits >> bit_count));
+        }
+    }
+
+    return decoded;
+}
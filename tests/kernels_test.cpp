@@ -0,0 +1,605 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "base64.h"
+#include "helpers.h"
+
+
+constexpr size_t max_test_size = 1024;
+
+
+// runs the test body for every kernel supported by the CPU
+template <typename test_function>
+void for_each_kernel(test_function test)
+{
+    using namespace base64;
+
+    const kernel_t default_kernel = active_kernel();
+
+    for (const kernel_t kernel :
+        { kernel_t::scalar, kernel_t::scalar_x4, kernel_t::ssse3, kernel_t::avx2 })
+    {
+        if (!set_kernel(kernel))
+            continue;
+
+        CAPTURE(static_cast<int>(kernel));
+        test();
+    }
+
+    set_kernel(default_kernel);
+}
+
+
+TEST_CASE("encode_matches_reference")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        for (size_t size = 0; size <= max_test_size; ++size)
+        {
+            const std::vector<uint8_t> data = make_random_array(size, static_cast<uint32_t>(size));
+            const std::string expected = reference_encode(def_encoding_t::alphabet(), '=', data);
+
+            std::string encoded(calc_encoded_size(size), '\0');
+            const error_code_t error = encode(data, encoded);
+            REQUIRE(!error);
+            REQUIRE(encoded == expected);
+        }
+    });
+}
+
+
+TEST_CASE("url_encode_matches_reference")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        for (size_t size = 0; size <= max_test_size; ++size)
+        {
+            const std::vector<uint8_t> data = make_random_array(size, static_cast<uint32_t>(size));
+            const std::string expected = reference_encode(url_encoding_t::alphabet(), 0, data);
+
+            std::string encoded(calc_encoded_size_url(size), '\0');
+            const error_code_t error = encode_url(data, encoded);
+            REQUIRE(!error);
+            REQUIRE(encoded == expected);
+        }
+    });
+}
+
+
+TEST_CASE("decode_matches_reference")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        for (size_t size = 0; size <= max_test_size; ++size)
+        {
+            const std::vector<uint8_t> data = make_random_array(size, static_cast<uint32_t>(size));
+            const std::string encoded = reference_encode(def_encoding_t::alphabet(), '=', data);
+            REQUIRE(reference_decode(def_encoding_t::alphabet(), encoded) == data);
+
+            std::vector<uint8_t> decoded(calc_decoded_size(encoded));
+            const error_code_t error = decode(encoded, decoded);
+            REQUIRE(!error);
+            REQUIRE(decoded == data);
+
+            std::vector<uint8_t> strict_decoded(calc_decoded_size(encoded));
+            REQUIRE(!decode_strict(encoded, strict_decoded));
+            REQUIRE(strict_decoded == data);
+        }
+    });
+}
+
+
+TEST_CASE("url_decode_matches_reference")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        for (size_t size = 0; size <= max_test_size; ++size)
+        {
+            const std::vector<uint8_t> data = make_random_array(size, static_cast<uint32_t>(size));
+            const std::string encoded = reference_encode(url_encoding_t::alphabet(), 0, data);
+
+            std::vector<uint8_t> decoded(calc_decoded_size_url(encoded));
+            const error_code_t error = decode_url(encoded, decoded);
+            REQUIRE(!error);
+            REQUIRE(decoded == data);
+
+            std::vector<uint8_t> strict_decoded(calc_decoded_size_url(encoded));
+            REQUIRE(!decode_url_strict(encoded, strict_decoded));
+            REQUIRE(strict_decoded == data);
+        }
+    });
+}
+
+
+TEST_CASE("decode_reports_first_bad_symbol")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        const std::vector<uint8_t> data = make_random_array(300);
+        const std::string encoded = reference_encode(def_encoding_t::alphabet(), '=', data);
+        std::vector<uint8_t> decoded(calc_decoded_size(encoded));
+
+        for (size_t pos = 0; pos < encoded.size() - 4; ++pos)
+        {
+            for (const char bad_symbol : { '*', '-', '\x80', '\xFF' })
+            {
+                std::string corrupted = encoded;
+                corrupted[pos] = bad_symbol;
+                corrupted[encoded.size() - 4] = bad_symbol;
+
+                const error_code_t error = decode(corrupted, decoded);
+                REQUIRE(error.type() == error_type_t::non_alphabetic_symbol);
+
+                char expected_msg[128];
+                std::snprintf(expected_msg, sizeof(expected_msg),
+                    "The buffer has the non-alphabetical character 0x%02X at index %zu.",
+                    static_cast<uint8_t>(bad_symbol), pos);
+                REQUIRE(error.msg() == expected_msg);
+            }
+        }
+    });
+}
+
+
+TEST_CASE("decode_strict_reports_misplaced_pad")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        const std::vector<uint8_t> data = make_random_array(200);
+        const std::string encoded = reference_encode(def_encoding_t::alphabet(), '=', data);
+        std::vector<uint8_t> decoded(data.size());
+
+        for (size_t pos = 0; pos < encoded.size() - 4; ++pos)
+        {
+            std::string corrupted = encoded;
+            corrupted[pos] = '=';
+
+            REQUIRE(!decode(corrupted, decoded));
+
+            const error_code_t error = decode_strict(corrupted, decoded);
+            REQUIRE(error.type() == error_type_t::misplaced_pad);
+            REQUIRE(error.pos() == pos);
+
+            // the pad is the first error even if a non-alphabetic symbol follows in the quad
+            corrupted[pos + 2] = '*';
+            const error_code_t first_error = decode_strict(corrupted, decoded);
+            REQUIRE(first_error.type() == error_type_t::misplaced_pad);
+            REQUIRE(first_error.pos() == pos);
+        }
+    });
+}
+
+
+TEST_CASE("locate_invalid_symbol")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        const std::vector<uint8_t> data = make_random_array(120);
+        const std::string encoded = reference_encode(def_encoding_t::alphabet(), '=', data);
+        const std::string url_encoded = reference_encode(url_encoding_t::alphabet(), 0, data);
+
+        for (size_t size = 1; size <= encoded.size(); ++size)
+        {
+            for (const size_t pos : { size_t{ 0 }, size / 2, size - 1, size })
+            {
+                std::string corrupted = encoded.substr(0, size);
+                std::string url_corrupted = url_encoded.substr(0, size);
+
+                corrupted[size / 3] = '=';      // a pad is not an invalid symbol
+                url_corrupted[size / 3] = '=';  // unless the encoding has no pad
+
+                if (pos < size)
+                {
+                    corrupted[pos] = '\x80';
+                    url_corrupted[pos] = '\x80';
+                }
+
+                const auto * ptr =
+                    static_cast<const uint8_t *>(static_cast<const void *>(corrupted.data()));
+                const auto * url_ptr =
+                    static_cast<const uint8_t *>(static_cast<const void *>(url_corrupted.data()));
+
+                REQUIRE(detail::locate_invalid<def_encoding_t>(ptr, size) == pos);
+                REQUIRE(detail::locate_invalid<url_encoding_t>(url_ptr, size)
+                    == std::min(pos, size / 3));
+            }
+        }
+    });
+}
+
+
+TEST_CASE("validate_matches_decode")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        const std::vector<uint8_t> data = make_random_array(300);
+        const std::string encoded = reference_encode(def_encoding_t::alphabet(), '=', data);
+        const std::string url_encoded = reference_encode(url_encoding_t::alphabet(), 0, data);
+        std::vector<uint8_t> decoded(data.size());
+
+        REQUIRE(!validate(encoded));
+        REQUIRE(!validate_url(url_encoded));
+        REQUIRE(!validate(std::string_view{}));
+        REQUIRE(validate(encoded.substr(1)).type() == error_type_t::invalid_buffer_size);
+        REQUIRE(validate_url(url_encoded.substr(3)).type() == error_type_t::invalid_buffer_size);
+
+        for (size_t pos = 0; pos < encoded.size(); ++pos)
+        {
+            // a pad inside the data is accepted by the decoding functions
+            for (const char bad_symbol : { '*', '-', '=', '\x80', '\xFF' })
+            {
+                std::string corrupted = encoded;
+                corrupted[pos] = bad_symbol;
+
+                const error_code_t expected = decode(corrupted, decoded);
+                const error_code_t error = validate(corrupted);
+                REQUIRE(error.type() == expected.type());
+                REQUIRE(error.pos() == expected.pos());
+
+                std::string url_corrupted =
+                    url_encoded.substr(0, std::min(pos, url_encoded.size() - 1));
+                url_corrupted += bad_symbol;
+                url_corrupted += url_encoded.substr(url_corrupted.size());
+
+                const error_code_t url_expected = decode_url(url_corrupted, decoded);
+                const error_code_t url_error = validate_url(url_corrupted);
+                REQUIRE(url_error.type() == url_expected.type());
+                REQUIRE(url_error.pos() == url_expected.pos());
+            }
+        }
+    });
+}
+
+
+TEST_CASE("decode_inplace_matches_decode")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        const std::vector<uint8_t> data = make_random_array(400);
+
+        for (size_t size = 0; size <= data.size(); size += (size < 40 ? 1 : 37))
+        {
+            const std::vector<uint8_t> part(data.begin(), data.begin() + size);
+            const std::string encoded = reference_encode(def_encoding_t::alphabet(), '=', part);
+            const std::string url_encoded = reference_encode(url_encoding_t::alphabet(), 0, part);
+
+            std::string buffer = encoded;
+            size_t raw_size = 0;
+            REQUIRE(!decode_inplace(buffer, raw_size));
+            REQUIRE(raw_size == size);
+            REQUIRE((size == 0 || std::memcmp(part.data(), buffer.data(), raw_size) == 0));
+
+            buffer = url_encoded;
+            REQUIRE(!decode_url_inplace(buffer, raw_size));
+            REQUIRE(raw_size == size);
+            REQUIRE((size == 0 || std::memcmp(part.data(), buffer.data(), raw_size) == 0));
+        }
+
+        // the bad symbol is reported and the data before it is decoded, including the first
+        // blocks where the output would overlap the input of the failed block
+        const std::string encoded = reference_encode(def_encoding_t::alphabet(), '=', data);
+
+        for (size_t pos = 0; pos < encoded.size(); pos += (pos < 100 ? 1 : 13))
+        {
+            std::string corrupted = encoded;
+            corrupted[pos] = '*';
+
+            std::vector<uint8_t> decoded(data.size());
+            const error_code_t expected = decode(corrupted, decoded);
+
+            size_t raw_size = 0;
+            const error_code_t error = decode_inplace(corrupted, raw_size);
+            REQUIRE(error.type() == expected.type());
+            REQUIRE(error.pos() == pos);
+            REQUIRE(error.symbol() == '*');
+            REQUIRE(raw_size == 3 * (pos / 4));
+            REQUIRE(std::memcmp(data.data(), corrupted.data(), raw_size) == 0);
+        }
+    });
+}
+
+
+TEST_CASE("encode_inplace_matches_encode")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        const std::vector<uint8_t> data = make_random_array(3000);
+
+        for (size_t size = 0; size <= data.size(); size += (size < 300 ? 1 : 97))
+        {
+            const std::vector<uint8_t> part(data.begin(), data.begin() + size);
+
+            std::string buffer(calc_encoded_size(size), '\0');
+            std::copy(part.begin(), part.end(), buffer.begin());
+            REQUIRE(!encode_inplace(buffer, size));
+            REQUIRE(buffer == reference_encode(def_encoding_t::alphabet(), '=', part));
+
+            std::vector<uint8_t> url_buffer(calc_encoded_size_url(size));
+            std::copy(part.begin(), part.end(), url_buffer.begin());
+            REQUIRE(!encode_url_inplace(url_buffer, size));
+            REQUIRE(std::string(url_buffer.begin(), url_buffer.end())
+                == reference_encode(url_encoding_t::alphabet(), 0, part));
+        }
+
+        std::string small(3, 'x');
+        const error_code_t error = encode_inplace(small, 3 + 1);
+        REQUIRE(error.type() == error_type_t::insufficient_buffer_size);
+        REQUIRE(small == "xxx");
+    });
+}
+
+
+TEST_CASE("sinks_match_encode_decode")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        // several staging blocks and a partial one
+        const std::vector<uint8_t> data = make_random_array(10000);
+
+        for (const size_t size : { 0, 1, 2, 3, 3071, 3072, 3073, 6144, 10000 })
+        {
+            const std::vector<uint8_t> part(data.begin(), data.begin() + size);
+            const std::string expected = reference_encode(def_encoding_t::alphabet(), '=', part);
+            const std::string url_expected = reference_encode(url_encoding_t::alphabet(), 0, part);
+
+            std::string encoded;
+            size_t calls = 0;
+            encode_to_sink(part, [&](const char * block, size_t block_size)
+            {
+                REQUIRE(block_size <= staging_block_size);
+                encoded.append(block, block_size);
+                ++calls;
+            });
+            REQUIRE(encoded == expected);
+            REQUIRE(calls == (expected.size() + staging_block_size - 1) / staging_block_size);
+
+            std::string url_encoded;
+            encode_url_to_sink(part, std::back_inserter(url_encoded));
+            REQUIRE(url_encoded == url_expected);
+
+            std::vector<uint8_t> decoded;
+            REQUIRE(!decode_to_sink(expected, [&](const uint8_t * block, size_t block_size)
+            {
+                decoded.insert(decoded.end(), block, block + block_size);
+            }));
+            REQUIRE(decoded == part);
+
+            std::vector<uint8_t> url_decoded;
+            REQUIRE(!decode_url_to_sink(url_expected, std::back_inserter(url_decoded)));
+            REQUIRE(url_decoded == part);
+        }
+
+        // pads (accepted in the middle) and bad symbols around the block boundaries
+        const std::string encoded = reference_encode(def_encoding_t::alphabet(), '=', data);
+
+        for (const size_t pos : { 0, 4092, 4093, 4094, 4095, 4096, 5000, 8191, 13331, 13335 })
+        {
+            for (const char symbol : { '=', '*' })
+            {
+                std::string corrupted = encoded;
+                corrupted[pos] = symbol;
+                corrupted[4095] = '=';
+
+                std::vector<uint8_t> expected(3 * (corrupted.size() / 4));
+                const error_code_t expected_error = decode(corrupted, expected);
+                expected.resize(expected_error
+                    ? 3 * (expected_error.pos() / 4)
+                    : calc_decoded_size(corrupted));
+
+                std::vector<uint8_t> decoded;
+                const error_code_t error = decode_to_sink(corrupted, std::back_inserter(decoded));
+                REQUIRE(error.type() == expected_error.type());
+                REQUIRE(error.pos() == expected_error.pos());
+                REQUIRE(decoded == expected);
+            }
+        }
+
+        std::vector<uint8_t> decoded;
+        REQUIRE(decode_to_sink(encoded.substr(1), std::back_inserter(decoded)).type()
+            == error_type_t::invalid_buffer_size);
+        REQUIRE(decoded.empty());
+
+        // an lvalue output iterator is advanced past the output, a temporary one is copied
+        std::string encoded_chars(encoded.size(), '\0');
+        char * encoded_end = encoded_chars.data();
+        encode_to_sink(data, encoded_end);
+        REQUIRE(encoded_end == encoded_chars.data() + encoded.size());
+        REQUIRE(encoded_chars == encoded);
+
+        decoded.assign(data.size(), 0);
+        uint8_t * decoded_end = decoded.data();
+        REQUIRE(!decode_to_sink(encoded, decoded_end));
+        REQUIRE(decoded_end == decoded.data() + data.size());
+        REQUIRE(decoded == data);
+
+        decoded.assign(data.size(), 0);
+        decoded_end = decoded.data();
+        REQUIRE(!decode_to_sink(encoded, static_cast<uint8_t *>(decoded_end)));
+        REQUIRE(decoded_end == decoded.data());
+        REQUIRE(decoded == data);
+
+        // on error the iterator marks the end of the data decoded before the invalid symbol
+        std::string corrupted = encoded;
+        corrupted[5000] = '*';
+        decoded_end = decoded.data();
+        REQUIRE(decode_to_sink(corrupted, decoded_end).pos() == 5000);
+        REQUIRE(decoded_end == decoded.data() + 3 * (5000 / 4));
+    });
+}
+
+
+TEST_CASE("find_invalid_symbols")
+{
+    using namespace base64;
+
+    for_each_kernel([&]()
+    {
+        const std::vector<uint8_t> data = make_random_array(300);
+        std::string corrupted = reference_encode(def_encoding_t::alphabet(), '=', data);
+        std::string url_corrupted = reference_encode(url_encoding_t::alphabet(), 0, data);
+        std::vector<size_t> expected;
+
+        // clusters inside one block and positions spread over several blocks and the scalar tail
+        for (const size_t pos : { 0, 1, 2, 31, 32, 33, 63, 100, 101, 255, 390, 398, 399 })
+        {
+            corrupted[pos] = (pos % 2) ? '*' : '\x80';
+            url_corrupted[pos] = corrupted[pos];
+            expected.push_back(pos);
+        }
+
+        std::vector<size_t> positions(expected.size() + 1);
+        REQUIRE(find_invalid_symbols(corrupted, positions) == expected.size());
+        REQUIRE(std::equal(expected.begin(), expected.end(), positions.begin()));
+
+        positions.assign(positions.size(), 0);
+        REQUIRE(find_invalid_symbols_url(url_corrupted, positions) == expected.size());
+        REQUIRE(std::equal(expected.begin(), expected.end(), positions.begin()));
+
+        // the output is limited by the span size
+        positions.assign(positions.size(), 0);
+        REQUIRE(find_invalid_symbols(corrupted, std::span(positions.data(), 4)) == 4);
+        REQUIRE(std::equal(positions.begin(), positions.begin() + 4, expected.begin()));
+        REQUIRE(positions[4] == 0);
+
+        REQUIRE(find_invalid_symbols(corrupted, std::span<size_t>()) == 0);
+        REQUIRE(find_invalid_symbols(std::string_view{}, positions) == 0);
+        const std::string valid = reference_encode(def_encoding_t::alphabet(), '=', data);
+        REQUIRE(find_invalid_symbols(valid, positions) == 0);
+
+        // every other symbol is invalid, the output fills up inside a block and in the scalar tail
+        std::string dense = valid;
+        expected.clear();
+
+        for (size_t pos = 1; pos < dense.size(); pos += 2)
+        {
+            dense[pos] = '\x80';
+            expected.push_back(pos);
+        }
+
+        for (const size_t max_count :
+            { size_t{ 1 }, size_t{ 7 }, size_t{ 16 }, size_t{ 190 }, expected.size() })
+        {
+            positions.assign(expected.size() + 1, 0);
+            const std::span<size_t> limited(positions.data(), max_count);
+            REQUIRE(find_invalid_symbols(dense, limited) == max_count);
+            REQUIRE(std::equal(expected.begin(), expected.begin() + max_count, positions.begin()));
+            REQUIRE(positions[max_count] == 0);
+        }
+    });
+}
+
+
+// the same layout as the built-in alphabets (served by the vector kernels) and a scalar-only one
+constexpr const char std_layout_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789*-";
+constexpr const char reversed_alphabet[] =
+    "~.9876543210zyxwvutsrqponmlkjihgfedcbaZYXWVUTSRQPONMLKJIHGFEDCBA";
+
+using std_layout_encoding = base64::encoding_traits_t<std_layout_alphabet, '='>;
+using reversed_encoding = base64::encoding_traits_t<reversed_alphabet, 0>;
+
+
+template <typename encoding_traits>
+void check_custom_encoding()
+{
+    using namespace base64;
+
+    constexpr char pad = static_cast<char>(encoding_traits::has_pad() ? encoding_traits::pad() : 0);
+
+    for (size_t size = 0; size <= max_test_size; ++size)
+    {
+        const std::vector<uint8_t> data = make_random_array(size, static_cast<uint32_t>(size));
+        const std::string expected = reference_encode(encoding_traits::alphabet(), pad, data);
+
+        std::string encoded(calc_encoded_size_impl<encoding_traits>(size), '\0');
+        error_code_t error = encode_impl<encoding_traits>(
+            make_const_adapter(data), make_mutable_adapter(encoded));
+        REQUIRE(!error);
+        REQUIRE(encoded == expected);
+
+        std::vector<uint8_t> decoded(
+            calc_decoded_size_impl<encoding_traits>(make_const_adapter(encoded)));
+        error = decode_impl<encoding_traits>(
+            make_const_adapter(encoded), make_mutable_adapter(decoded));
+        REQUIRE(!error);
+        REQUIRE(decoded == data);
+    }
+}
+
+
+TEST_CASE("custom_encodings_match_reference")
+{
+    static_assert(base64::detail::simd_traits_t<std_layout_encoding>::supported());
+    static_assert(!base64::detail::simd_traits_t<reversed_encoding>::supported());
+
+    for_each_kernel([&]()
+    {
+        check_custom_encoding<std_layout_encoding>();
+        check_custom_encoding<reversed_encoding>();
+    });
+}
+
+
+TEST_CASE("kernel_selection")
+{
+    using namespace base64;
+
+    const kernel_t default_kernel = active_kernel();
+    REQUIRE(is_kernel_supported(default_kernel));
+    REQUIRE(is_kernel_supported(kernel_t::scalar));
+
+    // the best supported kernel, the unrolled scalar one without vector kernels
+    if (std::getenv("BASE64_FORCE_KERNEL") == nullptr)
+    {
+        const kernel_t best_kernel =
+            is_kernel_supported(kernel_t::avx2) ? kernel_t::avx2 :
+            is_kernel_supported(kernel_t::ssse3) ? kernel_t::ssse3 : kernel_t::scalar_x4;
+        REQUIRE(detail::select_kernel() == best_kernel);
+    }
+
+    REQUIRE(is_kernel_supported(kernel_t::scalar_x4));
+
+    REQUIRE(set_kernel(kernel_t::scalar_x4));
+    REQUIRE(active_kernel() == kernel_t::scalar_x4);
+
+    REQUIRE(set_kernel(kernel_t::scalar));
+    REQUIRE(active_kernel() == kernel_t::scalar);
+
+    if (!is_kernel_supported(kernel_t::avx2))
+    {
+        REQUIRE(!set_kernel(kernel_t::avx2));
+        REQUIRE(active_kernel() == kernel_t::scalar);
+    }
+
+    REQUIRE(set_kernel(default_kernel));
+    REQUIRE(active_kernel() == default_kernel);
+}
@@ -0,0 +1,81 @@
+#include "base64_raw.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "doctest/doctest.h"
+
+
+TEST_CASE("encode_raw")
+{
+    using namespace base64;
+
+    const uint8_t data[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A' };
+    char encoded[16] = {};
+
+    raw_result_t result = encode_raw(data, sizeof(data), encoded, 15);
+    REQUIRE(result.status == error_type_t::insufficient_buffer_size);
+    REQUIRE(result.consumed == 0);
+    REQUIRE(result.written == 0);
+
+    result = encode_raw(data, sizeof(data), encoded, sizeof(encoded));
+    REQUIRE(result.status == error_type_t::no_error);
+    REQUIRE(result.consumed == sizeof(data));
+    REQUIRE(result.written == 16);
+    REQUIRE(std::memcmp(encoded, "MDEyMzQ1Njc4OUE=", 16) == 0);
+
+    result = encode_url_raw(data, sizeof(data), encoded, sizeof(encoded));
+    REQUIRE(result.status == error_type_t::no_error);
+    REQUIRE(result.consumed == sizeof(data));
+    REQUIRE(result.written == 15);
+    REQUIRE(std::memcmp(encoded, "MDEyMzQ1Njc4OUE", 15) == 0);
+}
+
+
+TEST_CASE("decode_raw")
+{
+    using namespace base64;
+
+    uint8_t decoded[12] = {};
+
+    // the upper bound of the size (3 bytes) isn't required, the padding is taken into account
+    raw_result_t result = decode_raw("MDE=", 4, decoded, 2);
+    REQUIRE(result.status == error_type_t::no_error);
+    REQUIRE(result.consumed == 4);
+    REQUIRE(result.written == 2);
+    REQUIRE(std::memcmp(decoded, "01", 2) == 0);
+
+    result = decode_raw("MA==", 4, decoded, sizeof(decoded));
+    REQUIRE(result.status == error_type_t::no_error);
+    REQUIRE(result.written == 1);
+    REQUIRE(decoded[0] == '0');
+
+    result = decode_raw("MDEyMzQ1Njc4OUFC", 16, decoded, sizeof(decoded));
+    REQUIRE(result.status == error_type_t::no_error);
+    REQUIRE(result.consumed == 16);
+    REQUIRE(result.written == 12);
+    REQUIRE(std::memcmp(decoded, "0123456789AB", 12) == 0);
+
+    result = decode_raw("MDEyMzQ1Njc4OUFC", 16, decoded, 11);
+    REQUIRE(result.status == error_type_t::insufficient_buffer_size);
+    REQUIRE(result.consumed == 0);
+    REQUIRE(result.written == 0);
+
+    result = decode_raw("MDEyMzQ1Njc4OUF", 15, decoded, sizeof(decoded));
+    REQUIRE(result.status == error_type_t::invalid_buffer_size);
+
+    result = decode_raw("MDEyMzQ1Nj*4OUFC", 16, decoded, sizeof(decoded));
+    REQUIRE(result.status == error_type_t::non_alphabetic_symbol);
+    REQUIRE(result.consumed == 10);
+    REQUIRE(result.written == 6);
+    REQUIRE(std::memcmp(decoded, "012345", 6) == 0);
+
+    result = decode_url_raw("MDEyMzQ1Njc4OUE", 15, decoded, 11);
+    REQUIRE(result.status == error_type_t::no_error);
+    REQUIRE(result.consumed == 15);
+    REQUIRE(result.written == 11);
+    REQUIRE(std::memcmp(decoded, "0123456789A", 11) == 0);
+
+    result = decode_url_raw("MDEyMzQ1Njc4OUE", 15, decoded, 10);
+    REQUIRE(result.status == error_type_t::insufficient_buffer_size);
+}
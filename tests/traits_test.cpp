@@ -133,3 +133,71 @@ TEST_CASE("custom_encoding_traits_without_pad_consistency")
     REQUIRE(pos == 63);
     REQUIRE(!wrong_pos);
 }
+
+
+template <typename encoding_traits>
+bool check_pair_table()
+{
+    const auto & pairs = base64::detail::tables_t<encoding_traits>::pairs;
+
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        const uint16_t expected = static_cast<uint16_t>(
+            (encoding_traits::char_at(i >> 6) << 8) | encoding_traits::char_at(i & 0x3F));
+
+        if (pairs[i] != expected)
+            return false;
+    }
+
+    return true;
+}
+
+
+TEST_CASE("pair_tables_consistency")
+{
+    using namespace base64;
+
+    static_assert(detail::tables_t<def_encoding_t>::pairs[0] == ('A' << 8 | 'A'));
+    static_assert(detail::tables_t<url_encoding_t>::pairs[4095] == ('_' << 8 | '_'));
+    static_assert(detail::tables_t<encoding_with_pad>::pairs[4094] == ('-' << 8 | '*'));
+
+    REQUIRE(check_pair_table<def_encoding_t>());
+    REQUIRE(check_pair_table<url_encoding_t>());
+    REQUIRE(check_pair_table<encoding_with_pad>());
+    REQUIRE(check_pair_table<encoding_without_pad>());
+}
+
+
+template <typename encoding_traits>
+bool check_shifted_tables()
+{
+    using tables = base64::detail::tables_t<encoding_traits>;
+
+    for (uint32_t symbol = 0; symbol < 256; ++symbol)
+    {
+        const uint32_t index = encoding_traits::index_of(static_cast<uint8_t>(symbol));
+
+        for (uint32_t k = 0; k < 4; ++k)
+        {
+            const uint32_t expected = index == encoding_traits::invalid_index()
+                ? tables::bad_symbol
+                : index << (18 - 6 * k);
+
+            if (tables::shifted[k][symbol] != expected)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+TEST_CASE("shifted_tables_consistency")
+{
+    using namespace base64;
+
+    REQUIRE(check_shifted_tables<def_encoding_t>());
+    REQUIRE(check_shifted_tables<url_encoding_t>());
+    REQUIRE(check_shifted_tables<encoding_with_pad>());
+    REQUIRE(check_shifted_tables<encoding_without_pad>());
+}
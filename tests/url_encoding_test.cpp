@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <ostream>
@@ -56,6 +57,33 @@ TEST_CASE("url_decode_errors")
 }
 
 
+TEST_CASE("url_decode_strict_errors")
+{
+    using namespace base64;
+    using namespace std::string_view_literals;
+
+    std::string decoded(12, '\0');
+
+    REQUIRE(!decode_url("MDEyMZ"sv, decoded));
+    REQUIRE(!decode_url("MDEyMzR"sv, decoded));
+
+    REQUIRE(!decode_url_strict("MDEyMw"sv, decoded));
+    REQUIRE(!decode_url_strict("MDEyMzQ"sv, decoded));
+
+    error_code_t error = decode_url_strict("MDEyMZ"sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_canonical_trailing_bits);
+    REQUIRE(error.pos() == 5);
+
+    error = decode_url_strict("MDEyMzR"sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_canonical_trailing_bits);
+    REQUIRE(error.pos() == 6);
+
+    error = decode_url_strict("MDEyMz="sv, decoded);
+    REQUIRE(error.type() == error_type_t::non_alphabetic_symbol);
+    REQUIRE(error.pos() == 6);
+}
+
+
 TEST_CASE("url_encode_empty_data")
 {
     using namespace base64;
@@ -554,6 +582,37 @@ TEST_CASE("url_decode_binary_data")
 }
 
 
+TEST_CASE("url_allocating_functions")
+{
+    using namespace base64;
+
+    const std::vector<uint8_t> binary = make_bin_array(512);
+
+    for (const size_t size : { 0, 1, 2, 3, 100, 511, 512 })
+    {
+        const std::vector<uint8_t> data(binary.begin(), binary.begin() + size);
+
+        std::string expected(calc_encoded_size_url(size), '\0');
+        REQUIRE(!encode_url(data, expected));
+
+        const std::string encoded = encode_url_to_string(data);
+        REQUIRE(encoded == expected);
+
+        byte_vector_t decoded;
+        REQUIRE(!decode_url_to_vector(encoded, decoded));
+        REQUIRE(std::equal(data.begin(), data.end(), decoded.begin(), decoded.end()));
+
+        std::string appended = "prefix";
+        encode_url_append(data, appended);
+        REQUIRE(appended == "prefix" + expected);
+
+        std::vector<uint8_t> appended_bytes(3, '*');
+        encode_url_append(data, appended_bytes);
+        REQUIRE(appended_bytes.size() == expected.size() + 3);
+        REQUIRE(std::equal(expected.begin(), expected.end(), appended_bytes.begin() + 3));
+    }
+}
+
 TEST_CASE("url_encode_utf8")
 {
     using namespace base64;